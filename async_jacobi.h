@@ -0,0 +1,137 @@
+/*
+ * Asynchronous (Chaotic) Jacobi
+ * Barrier-free sweeps over a shared iterate with lock-free termination
+ *
+ * Every thread owns a contiguous block of rows (the static partition) and
+ * sweeps it as often as it can, without waiting for the others:
+ *   1. copy the shared x into a private snapshot (relaxed atomic loads, so
+ *      the reads race with other threads' stores without undefined
+ *      behaviour; O(n) against the O(n^2 / T) row work)
+ *   2. update its rows from the snapshot with the SIMD row kernel
+ *   3. publish the new values of its rows (relaxed atomic stores)
+ * A fast thread therefore does more sweeps of its rows than a slow one
+ * instead of idling at a barrier. For a strictly diagonally dominant A the
+ * iteration converges for any such interleaving (Chazan-Miranker).
+ *
+ * Termination is lock-free. One 64-bit atomic holds a generation number
+ * (high half) and a count of converged threads (low half):
+ *   - a thread whose sweep changed some row by >= tolerance starts a new
+ *     generation with count 0, so every thread has to confirm again
+ *   - a thread whose sweep stayed below tolerance, with no new generation
+ *     started while it swept, adds itself to the count of the current
+ *     generation (once per generation, by compare-and-swap)
+ * The thread that brings the count to T raises the stop flag: every thread
+ * has then swept against the current values without a large change. A
+ * thread that only converged against stale values of a descheduled
+ * neighbour is reset by the neighbour's first large update. Any thread
+ * also stops all of them after maxIterations local sweeps.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+
+// Termination word: generation << 32 | converged-thread count
+inline uint64_t asyncGeneration(uint64_t state) { return state >> 32; }
+inline uint64_t asyncCount(uint64_t state) { return state & 0xffffffffu; }
+
+struct AsyncStats {
+    int minSweeps = 0; // local sweeps of the slowest thread
+    int maxSweeps = 0; // local sweeps of the fastest thread
+    double avgSweeps = 0.0;
+};
+
+// Asynchronous parallel Jacobi; returns the local sweep count of the
+// fastest thread. Same interface and tolerance meaning as jacobiParallel.
+inline int jacobiParallelAsync(const DenseMatrix& A, const std::vector<double>& b,
+                               std::vector<double>& x, int n, double tolerance,
+                               int maxIterations, int numThreads, AsyncStats* stats = nullptr) {
+    std::vector<std::atomic<double>> shared(n);
+    for (int i = 0; i < n; i++) {
+        shared[i].store(x[i], std::memory_order_relaxed);
+    }
+    std::atomic<uint64_t> termination(0);
+    std::atomic<bool> stop(false);
+    std::vector<int> sweeps(std::max(1, numThreads), 0);
+    int teamSize = 1;
+    RowDotFn dot = activeRowDotKernel().fn;
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        const int t = omp_get_thread_num();
+        const int T = omp_get_num_threads();
+        const int lo = (int)((long long)n * t / T);
+        const int hi = (int)((long long)n * (t + 1) / T);
+        std::vector<double> snapshot(n);
+        std::vector<double> block(hi - lo);
+        int localSweeps = 0;
+        uint64_t countedGeneration = UINT64_MAX; // generation this thread is counted in
+
+        while (!stop.load(std::memory_order_acquire)) {
+            uint64_t before = asyncGeneration(termination.load(std::memory_order_acquire));
+            for (int j = 0; j < n; j++) {
+                snapshot[j] = shared[j].load(std::memory_order_relaxed);
+            }
+
+            double localMax = 0.0;
+            for (int i = lo; i < hi; i++) {
+                block[i - lo] = jacobiRowUpdate(dot, A.rowPtr(i), snapshot.data(), b[i], i, n);
+                localMax = std::max(localMax, std::fabs(block[i - lo] - snapshot[i]));
+            }
+            for (int i = lo; i < hi; i++) {
+                shared[i].store(block[i - lo], std::memory_order_relaxed);
+            }
+            localSweeps++;
+
+            uint64_t state = termination.load(std::memory_order_acquire);
+            if (localMax >= tolerance) {
+                // Large change: new generation, nobody counts as converged
+                while (!termination.compare_exchange_weak(
+                    state, (asyncGeneration(state) + 1) << 32, std::memory_order_acq_rel)) {
+                }
+            } else {
+                // Count once per generation, and only if none began mid-sweep
+                while (asyncGeneration(state) == before && countedGeneration != before) {
+                    if (termination.compare_exchange_weak(state, state + 1,
+                                                          std::memory_order_acq_rel)) {
+                        countedGeneration = before;
+                        if (asyncCount(state + 1) == (uint64_t)T) {
+                            stop.store(true, std::memory_order_release);
+                        }
+                    }
+                }
+            }
+            if (localSweeps >= maxIterations) {
+                stop.store(true, std::memory_order_release);
+            }
+        }
+        sweeps[t] = localSweeps;
+        #pragma omp master
+        teamSize = T;
+    }
+    sweeps.resize(teamSize);
+
+    for (int i = 0; i < n; i++) {
+        x[i] = shared[i].load(std::memory_order_relaxed);
+    }
+
+    AsyncStats s;
+    s.minSweeps = *std::min_element(sweeps.begin(), sweeps.end());
+    s.maxSweeps = *std::max_element(sweeps.begin(), sweeps.end());
+    for (int v : sweeps) {
+        s.avgSweeps += v;
+    }
+    s.avgSweeps /= sweeps.size();
+    if (stats) {
+        *stats = s;
+    }
+    return s.maxSweeps;
+}
@@ -0,0 +1,438 @@
+/*
+ * Sweep Autotuner
+ * Short trial sweeps over the tunable parts of the dense Jacobi sweep,
+ * with the winner cached per (machine, n) in a text file
+ *
+ * Tuned parameters:
+ *   threads      1, 2, 4, ... up to the available hardware threads
+ *   schedule     static / dynamic / guided with a few chunk sizes, applied
+ *                through schedule(runtime) + omp_set_schedule
+ *   kernel       every row kernel the CPU supports (availableRowDotKernels)
+ *   layout       A as is, split D^-1 + R, or cache-blocked (tuned tiles)
+ *   precision    double, or float / bfloat16 storage of A when the caller
+ *                allows reduced precision (it limits the attainable residual)
+ * The search is coordinate-wise in that order, each step keeping the best
+ * value of the previous ones, so it costs a few dozen trials instead of
+ * the full cross product. A trial is at least `trialSweeps` sweeps (more for
+ * small n, so a trial lasts minTrialMs) with tolerance 0, timed twice; the
+ * faster run counts.
+ *
+ * Cache file: one line per (machine, n) holding the tuned configuration;
+ * later runs look the entry up and start with it without any trials, as
+ * long as it fits the run (configAllowed): an entry with reduced precision
+ * or more threads than the run may use is tuned again and replaced.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+#include "jacobi_split.h"
+#include "mixed_precision.h"
+#include "thread_reduction.h"
+#include "tiled_jacobi.h"
+
+enum class SweepLayout { Dense, Split, Tiled };
+enum class SweepPrecision { Double, Float, Bfloat16 };
+
+struct SweepConfig {
+    int threads = 1;
+    omp_sched_t schedule = omp_sched_static;
+    int chunk = 0;           // 0 = the schedule's default chunking
+    std::string kernel;      // row kernel name; empty = best supported
+    SweepLayout layout = SweepLayout::Dense;
+    SweepPrecision precision = SweepPrecision::Double;
+    TileConfig tiles;        // used by SweepLayout::Tiled
+    double msPerSweep = 0.0; // measured when tuned
+};
+
+inline const char* scheduleName(omp_sched_t kind) {
+    switch (kind) {
+    case omp_sched_dynamic: return "dynamic";
+    case omp_sched_guided: return "guided";
+    case omp_sched_auto: return "auto";
+    default: return "static";
+    }
+}
+
+inline const char* layoutName(SweepLayout layout) {
+    switch (layout) {
+    case SweepLayout::Split: return "split";
+    case SweepLayout::Tiled: return "tiled";
+    default: return "dense";
+    }
+}
+
+inline const char* precisionName(SweepPrecision precision) {
+    switch (precision) {
+    case SweepPrecision::Float: return "float";
+    case SweepPrecision::Bfloat16: return "bfloat16";
+    default: return "double";
+    }
+}
+
+// One-line description for reports
+inline std::string describeConfig(const SweepConfig& c) {
+    std::ostringstream os;
+    os << c.threads << " threads, ";
+    // Tiled and reduced-precision sweeps use their own static partition and kernels
+    if (c.layout != SweepLayout::Tiled && c.precision == SweepPrecision::Double) {
+        os << scheduleName(c.schedule);
+        if (c.chunk > 0) {
+            os << "," << c.chunk;
+        }
+        os << ", kernel " << (c.kernel.empty() ? activeRowDotKernel().name : c.kernel.c_str())
+           << ", ";
+    }
+    os << layoutName(c.layout);
+    if (c.layout == SweepLayout::Tiled) {
+        os << " (" << c.tiles.rowBlock << " rows x "
+           << (c.tiles.colBlock > 0 ? std::to_string(c.tiles.colBlock) : std::string("row"))
+           << ")";
+    }
+    os << ", " << precisionName(c.precision);
+    return os.str();
+}
+
+// CPU model and hardware thread count, e.g. "Intel(R)_Xeon(R)_Processor/8t"
+inline std::string machineSignature() {
+    std::string model = "unknown";
+#if defined(__linux__)
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                model = line.substr(line.find_first_not_of(" \t", colon + 1));
+            }
+            break;
+        }
+    }
+#endif
+    std::replace(model.begin(), model.end(), ' ', '_');
+    return model + "/" + std::to_string(std::max(1u, std::thread::hardware_concurrency())) + "t";
+}
+
+// Dense or split sweep with a runtime schedule and a chosen row kernel.
+// invDiag == nullptr: M is A; otherwise M is the split R (zero diagonal).
+inline int jacobiParallelScheduled(const DenseMatrix& M, const double* invDiag,
+                                   const std::vector<double>& b, std::vector<double>& x, int n,
+                                   double tolerance, int maxIterations, const SweepConfig& c) {
+    std::vector<double> x_new(n, 0.0);
+    RowDotFn dot = c.kernel.empty() ? activeRowDotKernel().fn
+                                    : findRowDotKernel(c.kernel.c_str()).fn;
+    ThreadReducer maxDiffReducer(c.threads);
+    int iterations = 0;
+
+    // run-sched-var is inherited by the implicit tasks of the regions below
+    omp_set_schedule(c.schedule, c.chunk);
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+        const double* xCur = x.data();
+        double* xNext = x_new.data();
+        maxDiffReducer.reset(0.0);
+
+        #pragma omp parallel num_threads(c.threads)
+        {
+            double localMax = 0.0;
+
+            #pragma omp for schedule(runtime) nowait
+            for (int i = 0; i < n; i++) {
+                const double* Mi = M.rowPtr(i);
+                if (invDiag) {
+                    xNext[i] = jacobiSplitUpdate(dot(Mi, xCur, n), b[i], invDiag[i]);
+                } else {
+                    xNext[i] = jacobiRowUpdate(dot, Mi, xCur, b[i], i, n);
+                }
+                localMax = std::max(localMax, std::fabs(xNext[i] - xCur[i]));
+            }
+
+            maxDiffReducer.publishMax(localMax);
+        }
+
+        x.swap(x_new);
+        iterations++;
+
+        if (maxDiffReducer.max() < tolerance) {
+            break;
+        }
+    }
+
+    return iterations;
+}
+
+// A together with the derived forms a configuration may need, each built
+// on first use (the split and reduced-precision copies cost one pass over A)
+class TunableSystem {
+public:
+    explicit TunableSystem(const DenseMatrix& A) : A_(A) {}
+
+    int size() const { return A_.rows(); }
+
+    int solve(const std::vector<double>& b, std::vector<double>& x, double tolerance,
+              int maxIterations, const SweepConfig& c) {
+        const int n = size();
+        if (c.precision == SweepPrecision::Float) {
+            if (!float_) {
+                float_.reset(new MixedPrecisionMatrix<float>(convertPrecision<float>(A_, c.threads)));
+            }
+            return jacobiParallelMixed(*float_, b, x, n, tolerance, maxIterations, c.threads);
+        }
+        if (c.precision == SweepPrecision::Bfloat16) {
+            if (!bfloat16_) {
+                bfloat16_.reset(new MixedPrecisionMatrix<bfloat16>(
+                    convertPrecision<bfloat16>(A_, c.threads)));
+            }
+            return jacobiParallelMixed(*bfloat16_, b, x, n, tolerance, maxIterations, c.threads);
+        }
+        switch (c.layout) {
+        case SweepLayout::Split:
+            if (!split_) {
+                split_.reset(new DenseSplit(splitDense(A_, c.threads)));
+            }
+            return jacobiParallelScheduled(split_->R, split_->invDiag.data(), b, x, n, tolerance,
+                                           maxIterations, c);
+        case SweepLayout::Tiled:
+            return jacobiParallelTiled(A_, b, x, n, tolerance, maxIterations, c.threads, c.tiles);
+        default:
+            return jacobiParallelScheduled(A_, nullptr, b, x, n, tolerance, maxIterations, c);
+        }
+    }
+
+    const DenseMatrix& matrix() const { return A_; }
+
+private:
+    const DenseMatrix& A_;
+    std::unique_ptr<DenseSplit> split_;
+    std::unique_ptr<MixedPrecisionMatrix<float>> float_;
+    std::unique_ptr<MixedPrecisionMatrix<bfloat16>> bfloat16_;
+};
+
+struct AutotuneOptions {
+    int maxThreads = 1;
+    int trialSweeps = 5;      // minimum sweeps per trial
+    double minTrialMs = 5.0;  // small systems run more sweeps to reach this
+    bool allowReducedPrecision = false;
+};
+
+// True if a cached configuration may be used by a run with these options:
+// reduced precision only when the run allows it, and no more threads than
+// the run may use. Otherwise the size is tuned again.
+inline bool configAllowed(const SweepConfig& c, const AutotuneOptions& options) {
+    if (c.precision != SweepPrecision::Double && !options.allowReducedPrecision) {
+        return false;
+    }
+    return c.threads <= std::max(1, options.maxThreads);
+}
+
+// ms per sweep of configuration c (best of two timed trials)
+inline double timeTrial(TunableSystem& system, const std::vector<double>& b,
+                        const SweepConfig& c, int trialSweeps) {
+    std::vector<double> x(system.size());
+    system.solve(b, x, 0.0, 1, c); // builds derived forms outside the timing
+    double best = 0.0;
+    for (int repeat = 0; repeat < 2; repeat++) {
+        std::fill(x.begin(), x.end(), 0.0);
+        double start = omp_get_wtime();
+        system.solve(b, x, 0.0, trialSweeps, c);
+        double ms = (omp_get_wtime() - start) * 1000.0 / trialSweeps;
+        if (repeat == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+// Coordinate search over threads, schedule/chunk, kernel, layout and
+// precision; `trials` (if given) receives the number of timed configurations
+inline SweepConfig autotune(TunableSystem& system, const std::vector<double>& b,
+                            const AutotuneOptions& options, int* trials = nullptr) {
+    int count = 0;
+    SweepConfig best;
+    best.threads = std::max(1, options.maxThreads);
+
+    // Calibrate the trial length on the default configuration
+    double estimate = timeTrial(system, b, best, 1);
+    int sweeps = options.trialSweeps;
+    if (estimate > 0.0) {
+        sweeps = std::max(sweeps, std::min(1000, (int)std::ceil(options.minTrialMs / estimate)));
+    }
+    best.msPerSweep = timeTrial(system, b, best, sweeps);
+    count++;
+
+    auto consider = [&](SweepConfig candidate) {
+        candidate.msPerSweep = timeTrial(system, b, candidate, sweeps);
+        count++;
+        if (candidate.msPerSweep < best.msPerSweep) {
+            best = candidate;
+        }
+    };
+
+    // Thread count: powers of two below the maximum
+    for (int t = 1; t < options.maxThreads; t *= 2) {
+        SweepConfig c = best;
+        c.threads = t;
+        consider(c);
+    }
+
+    // Schedule kind and chunk size
+    const struct { omp_sched_t kind; int chunk; } schedules[] = {
+        {omp_sched_static, 16}, {omp_sched_static, 64}, {omp_sched_dynamic, 16},
+        {omp_sched_dynamic, 64}, {omp_sched_dynamic, 256}, {omp_sched_guided, 0},
+        {omp_sched_guided, 16}};
+    for (const auto& s : schedules) {
+        SweepConfig c = best;
+        c.schedule = s.kind;
+        c.chunk = s.chunk;
+        consider(c);
+    }
+
+    // Row kernel (the first available one is the default)
+    std::vector<RowDotKernel> kernels = availableRowDotKernels();
+    for (size_t k = 1; k < kernels.size(); k++) {
+        SweepConfig c = best;
+        c.kernel = kernels[k].name;
+        consider(c);
+    }
+
+    // Layout: split D^-1 + R, or cache-blocked with its own tile tuning
+    {
+        SweepConfig c = best;
+        c.layout = SweepLayout::Split;
+        consider(c);
+
+        c = best;
+        c.layout = SweepLayout::Tiled;
+        c.tiles = tuneTiles(system.matrix(), b, system.size(), c.threads);
+        consider(c);
+    }
+
+    if (options.allowReducedPrecision) {
+        for (SweepPrecision p : {SweepPrecision::Float, SweepPrecision::Bfloat16}) {
+            SweepConfig c = best;
+            c.precision = p;
+            c.layout = SweepLayout::Dense;
+            consider(c);
+        }
+    }
+
+    if (trials) {
+        *trials = count;
+    }
+    return best;
+}
+
+// Tuned configurations keyed by (machine signature, n), stored one per line:
+//   machine n threads schedule chunk kernel layout precision rowBlock colBlock msPerSweep
+class TuningCache {
+public:
+    // Missing file = empty cache; returns false only for a malformed file
+    bool load(const std::string& path, std::string& error) {
+        entries_.clear();
+        std::ifstream in(path);
+        if (!in) {
+            return true;
+        }
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(in, line)) {
+            lineNo++;
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream ls(line);
+            std::string machine, schedule, kernel, layout, precision;
+            int n;
+            SweepConfig c;
+            if (!(ls >> machine >> n >> c.threads >> schedule >> c.chunk >> kernel >> layout >>
+                  precision >> c.tiles.rowBlock >> c.tiles.colBlock >> c.msPerSweep) ||
+                !parseEnums(schedule, layout, precision, c) || !validValues(c)) {
+                error = path + ":" + std::to_string(lineNo) + ": malformed tuning entry";
+                return false;
+            }
+            c.kernel = kernel == "-" ? "" : kernel;
+            entries_[{machine, n}] = c;
+        }
+        return true;
+    }
+
+    bool save(const std::string& path, std::string& error) const {
+        std::ofstream out(path);
+        if (!out) {
+            error = "cannot write " + path;
+            return false;
+        }
+        out << "# machine n threads schedule chunk kernel layout precision rowBlock colBlock"
+               " msPerSweep\n";
+        for (const auto& entry : entries_) {
+            const SweepConfig& c = entry.second;
+            out << entry.first.first << ' ' << entry.first.second << ' ' << c.threads << ' '
+                << scheduleName(c.schedule) << ' ' << c.chunk << ' '
+                << (c.kernel.empty() ? "-" : c.kernel) << ' ' << layoutName(c.layout) << ' '
+                << precisionName(c.precision) << ' ' << c.tiles.rowBlock << ' '
+                << c.tiles.colBlock << ' ' << c.msPerSweep << '\n';
+        }
+        if (!out) {
+            error = "error writing " + path;
+            return false;
+        }
+        return true;
+    }
+
+    bool lookup(const std::string& machine, int n, SweepConfig& c) const {
+        auto it = entries_.find({machine, n});
+        if (it == entries_.end()) {
+            return false;
+        }
+        c = it->second;
+        return true;
+    }
+
+    void store(const std::string& machine, int n, const SweepConfig& c) {
+        entries_[{machine, n}] = c;
+    }
+
+private:
+    // Values the solvers accept: at least one thread, a non-negative chunk
+    // and tile length, and a row block with a kernel (1, 2, 4 or 8)
+    static bool validValues(const SweepConfig& c) {
+        const int rb = c.tiles.rowBlock;
+        return c.threads >= 1 && c.chunk >= 0 && c.tiles.colBlock >= 0 &&
+               (rb == 1 || rb == 2 || rb == 4 || rb == 8);
+    }
+
+    static bool parseEnums(const std::string& schedule, const std::string& layout,
+                           const std::string& precision, SweepConfig& c) {
+        if (schedule == "static") c.schedule = omp_sched_static;
+        else if (schedule == "dynamic") c.schedule = omp_sched_dynamic;
+        else if (schedule == "guided") c.schedule = omp_sched_guided;
+        else if (schedule == "auto") c.schedule = omp_sched_auto;
+        else return false;
+
+        if (layout == "dense") c.layout = SweepLayout::Dense;
+        else if (layout == "split") c.layout = SweepLayout::Split;
+        else if (layout == "tiled") c.layout = SweepLayout::Tiled;
+        else return false;
+
+        if (precision == "double") c.precision = SweepPrecision::Double;
+        else if (precision == "float") c.precision = SweepPrecision::Float;
+        else if (precision == "bfloat16") c.precision = SweepPrecision::Bfloat16;
+        else return false;
+        return true;
+    }
+
+    std::map<std::pair<std::string, int>, SweepConfig> entries_;
+};
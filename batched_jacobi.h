@@ -0,0 +1,241 @@
+/*
+ * Batched Multi-Right-Hand-Side Jacobi
+ * Solves A X = B for k right-hand sides with one pass over A per sweep
+ *
+ * The n x k blocks B and X are stored column by column as k x n matrices:
+ * B.rowPtr(c) is right-hand side c and X.rowPtr(c) its solution. A sweep is
+ * the mat-mat product A * X: every row of A is streamed from memory once and
+ * applied to four solution vectors at a time (rowDot4), which stay cache
+ * resident, so arithmetic intensity grows with k instead of re-reading A for
+ * every b.
+ *
+ * Every column has its own convergence test (max |x_new - x| < tolerance).
+ * Converged columns are copied to X and dropped from the active set, so
+ * later sweeps only do work for the columns still iterating.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+
+// out[c] = dot(a, x[c]) for four vectors; a is loaded once per element
+typedef void (*RowDot4Fn)(const double* a, const double* const* x, int n, double* out);
+
+inline void rowDot4Scalar(const double* a, const double* const* x, int n, double* out) {
+    const double* x0 = x[0];
+    const double* x1 = x[1];
+    const double* x2 = x[2];
+    const double* x3 = x[3];
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    for (int j = 0; j < n; j++) {
+        double v = a[j];
+        s0 += v * x0[j];
+        s1 += v * x1[j];
+        s2 += v * x2[j];
+        s3 += v * x3[j];
+    }
+    out[0] = s0;
+    out[1] = s1;
+    out[2] = s2;
+    out[3] = s3;
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+__attribute__((target("avx2,fma")))
+inline double horizontalSumAvx2(__m256d v) {
+    __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+__attribute__((target("avx2,fma")))
+inline void rowDot4Avx2(const double* a, const double* const* x, int n, double* out) {
+    const double* x0 = x[0];
+    const double* x1 = x[1];
+    const double* x2 = x[2];
+    const double* x3 = x[3];
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd();
+    __m256d s3 = _mm256_setzero_pd();
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256d v = _mm256_loadu_pd(a + j);
+        s0 = _mm256_fmadd_pd(v, _mm256_loadu_pd(x0 + j), s0);
+        s1 = _mm256_fmadd_pd(v, _mm256_loadu_pd(x1 + j), s1);
+        s2 = _mm256_fmadd_pd(v, _mm256_loadu_pd(x2 + j), s2);
+        s3 = _mm256_fmadd_pd(v, _mm256_loadu_pd(x3 + j), s3);
+    }
+    out[0] = horizontalSumAvx2(s0);
+    out[1] = horizontalSumAvx2(s1);
+    out[2] = horizontalSumAvx2(s2);
+    out[3] = horizontalSumAvx2(s3);
+    for (; j < n; j++) {
+        out[0] += a[j] * x0[j];
+        out[1] += a[j] * x1[j];
+        out[2] += a[j] * x2[j];
+        out[3] += a[j] * x3[j];
+    }
+}
+
+__attribute__((target("avx512f")))
+inline double horizontalSumAvx512(__m512d v) {
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, v);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+__attribute__((target("avx512f")))
+inline void rowDot4Avx512(const double* a, const double* const* x, int n, double* out) {
+    const double* x0 = x[0];
+    const double* x1 = x[1];
+    const double* x2 = x[2];
+    const double* x3 = x[3];
+    __m512d s0 = _mm512_setzero_pd();
+    __m512d s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd();
+    __m512d s3 = _mm512_setzero_pd();
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m512d v = _mm512_loadu_pd(a + j);
+        s0 = _mm512_fmadd_pd(v, _mm512_loadu_pd(x0 + j), s0);
+        s1 = _mm512_fmadd_pd(v, _mm512_loadu_pd(x1 + j), s1);
+        s2 = _mm512_fmadd_pd(v, _mm512_loadu_pd(x2 + j), s2);
+        s3 = _mm512_fmadd_pd(v, _mm512_loadu_pd(x3 + j), s3);
+    }
+    if (j < n) {
+        __mmask8 mask = (__mmask8)((1u << (n - j)) - 1u);
+        __m512d v = _mm512_maskz_loadu_pd(mask, a + j);
+        s0 = _mm512_fmadd_pd(v, _mm512_maskz_loadu_pd(mask, x0 + j), s0);
+        s1 = _mm512_fmadd_pd(v, _mm512_maskz_loadu_pd(mask, x1 + j), s1);
+        s2 = _mm512_fmadd_pd(v, _mm512_maskz_loadu_pd(mask, x2 + j), s2);
+        s3 = _mm512_fmadd_pd(v, _mm512_maskz_loadu_pd(mask, x3 + j), s3);
+    }
+    out[0] = horizontalSumAvx512(s0);
+    out[1] = horizontalSumAvx512(s1);
+    out[2] = horizontalSumAvx512(s2);
+    out[3] = horizontalSumAvx512(s3);
+}
+#endif
+
+// Four-vector kernel matching activeRowDotKernel's instruction set
+inline RowDot4Fn activeRowDot4() {
+#ifdef JACOBI_HAVE_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return rowDot4Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return rowDot4Avx2;
+    }
+#endif
+    return rowDot4Scalar;
+}
+
+struct BatchedStats {
+    std::vector<int> columnIterations; // sweep at which each column converged
+    long long columnSweeps = 0;        // sum over sweeps of active columns
+};
+
+// Batched Jacobi; B and X are k x n (row c = column c of the n x k block).
+// Returns the number of sweeps (the iteration count of the slowest column).
+inline int jacobiParallelBatched(const DenseMatrix& A, const DenseMatrix& B, DenseMatrix& X,
+                                 int n, int k, double tolerance, int maxIterations,
+                                 int numThreads, BatchedStats* stats = nullptr) {
+    RowDotFn dot = activeRowDotKernel().fn;
+    RowDot4Fn dot4 = activeRowDot4();
+
+    // Two working copies of the block; all active columns swap together
+    DenseMatrix work[2] = {X, DenseMatrix(k, n)};
+    std::vector<int> active(k);
+    for (int c = 0; c < k; c++) {
+        active[c] = c;
+    }
+
+    // Per-thread, per-column max diff, each thread's slice on its own lines
+    const int slice = (k + 7) / 8 * 8;
+    std::vector<double> threadMax((size_t)numThreads * slice, 0.0);
+
+    BatchedStats st;
+    st.columnIterations.assign(k, maxIterations);
+    int iterations = 0;
+    std::vector<int> remaining;
+    remaining.reserve(k);
+
+    for (int iter = 0; iter < maxIterations && !active.empty(); iter++) {
+        const DenseMatrix& cur = work[iter % 2];
+        DenseMatrix& next = work[(iter + 1) % 2];
+        const int m = (int)active.size();
+        std::fill(threadMax.begin(), threadMax.end(), 0.0);
+
+        #pragma omp parallel num_threads(numThreads)
+        {
+            double* localMax = threadMax.data() + (size_t)omp_get_thread_num() * slice;
+
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) {
+                const double* Ai = A.rowPtr(i);
+                int a = 0;
+                for (; a < m; a += 4) {
+                    int group = std::min(4, m - a);
+                    const double* xs[4];
+                    double sums[4];
+                    for (int g = 0; g < 4; g++) {
+                        xs[g] = cur.rowPtr(active[a + std::min(g, group - 1)]);
+                    }
+                    if (group == 1) {
+                        sums[0] = dot(Ai, xs[0], n);
+                    } else {
+                        dot4(Ai, xs, n, sums);
+                    }
+                    for (int g = 0; g < group; g++) {
+                        int c = active[a + g];
+                        double xi = xs[g][i];
+                        // Full row product minus the diagonal term
+                        double value = (B(c, i) - (sums[g] - Ai[i] * xi)) / Ai[i];
+                        next(c, i) = value;
+                        localMax[a + g] = std::max(localMax[a + g], std::fabs(value - xi));
+                    }
+                }
+            }
+        }
+
+        iterations++;
+        st.columnSweeps += m;
+
+        // Per-column convergence: combine the threads' maxima and drop the
+        // converged columns (their final iterate is in `next`)
+        remaining.clear();
+        for (int a = 0; a < m; a++) {
+            double maxDiff = 0.0;
+            for (int t = 0; t < numThreads; t++) {
+                maxDiff = std::max(maxDiff, threadMax[(size_t)t * slice + a]);
+            }
+            int c = active[a];
+            if (maxDiff < tolerance) {
+                std::memcpy(X.rowPtr(c), next.rowPtr(c), n * sizeof(double));
+                st.columnIterations[c] = iterations;
+            } else {
+                remaining.push_back(c);
+            }
+        }
+        active.swap(remaining);
+    }
+
+    // Columns that hit maxIterations
+    for (int c : active) {
+        std::memcpy(X.rowPtr(c), work[iterations % 2].rowPtr(c), n * sizeof(double));
+    }
+
+    if (stats) {
+        *stats = st;
+    }
+    return iterations;
+}
@@ -0,0 +1,191 @@
+/*
+ * Benchmark Harness
+ * Warmup + repeated trials with summary statistics, written as CSV or JSON
+ *
+ * Every (size, threads, variant) configuration is run `warmup` times
+ * untimed and then `trials` times timed. The report keeps min, median,
+ * p95, mean and standard deviation of the trial times, so a perf gate can
+ * compare medians (or p95) instead of a single noisy run. Output goes to a
+ * file whose extension selects the format (.json or .csv); the Python
+ * visualiser reads either one directly instead of scraping stdout.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+struct TrialStats {
+    int trials = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0; // sample standard deviation (0 for one trial)
+};
+
+// Summary of a set of samples; percentiles use linear interpolation
+inline TrialStats computeStats(std::vector<double> samples) {
+    TrialStats s;
+    s.trials = (int)samples.size();
+    if (samples.empty()) {
+        return s;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        double pos = p * (samples.size() - 1);
+        size_t lo = (size_t)std::floor(pos);
+        size_t hi = std::min(lo + 1, samples.size() - 1);
+        return samples[lo] + (pos - lo) * (samples[hi] - samples[lo]);
+    };
+    s.min = samples.front();
+    s.median = percentile(0.5);
+    s.p95 = percentile(0.95);
+    for (double v : samples) {
+        s.mean += v;
+    }
+    s.mean /= samples.size();
+    if (samples.size() > 1) {
+        double sq = 0.0;
+        for (double v : samples) {
+            sq += (v - s.mean) * (v - s.mean);
+        }
+        s.stddev = std::sqrt(sq / (samples.size() - 1));
+    }
+    return s;
+}
+
+struct BenchmarkRecord {
+    int n = 0;
+    int threads = 0;
+    std::string variant;  // "sequential", "parallel", "persistent", "device", ...
+    int iterations = 0;   // of the last trial
+    double residual = 0.0;
+    double gflops = 0.0;  // at the median time
+    TrialStats timeMs;
+};
+
+class BenchmarkHarness {
+public:
+    BenchmarkHarness(int warmup, int trials)
+        : warmup_(std::max(0, warmup)), trials_(std::max(1, trials)) {}
+
+    int warmup() const { return warmup_; }
+    int trials() const { return trials_; }
+
+    // Run `solve` warmup + trials times; it returns the iteration count and
+    // must reset its own state (initial guess) on every call
+    TrialStats measure(const std::function<int()>& solve, int* iterations = nullptr) const {
+        int iters = 0;
+        for (int w = 0; w < warmup_; w++) {
+            iters = solve();
+        }
+        std::vector<double> samples;
+        for (int t = 0; t < trials_; t++) {
+            double start = omp_get_wtime();
+            iters = solve();
+            samples.push_back((omp_get_wtime() - start) * 1000.0);
+        }
+        if (iterations) {
+            *iterations = iters;
+        }
+        return computeStats(samples);
+    }
+
+    void add(const BenchmarkRecord& record) { records_.push_back(record); }
+
+    // Extra top-level JSON member with an already formatted value (model
+    // fits, machine peaks); CSV output carries the records only
+    void addSection(const std::string& name, const std::string& json) {
+        sections_.push_back({name, json});
+    }
+    const std::vector<BenchmarkRecord>& records() const { return records_; }
+
+    // Write CSV for *.csv paths, JSON otherwise
+    bool write(const std::string& path, std::string& error) const {
+        std::ofstream out(path);
+        if (!out) {
+            error = "cannot write " + path;
+            return false;
+        }
+        bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        out.precision(9);
+        if (csv) {
+            writeCsv(out);
+        } else {
+            writeJson(out);
+        }
+        if (!out) {
+            error = "error writing " + path;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void writeCsv(std::ostream& out) const {
+        out << "n,threads,variant,iterations,trials,min_ms,median_ms,p95_ms,mean_ms,stddev_ms,"
+               "gflops,residual\n";
+        for (const BenchmarkRecord& r : records_) {
+            out << r.n << ',' << r.threads << ',' << r.variant << ',' << r.iterations << ','
+                << r.timeMs.trials << ',' << r.timeMs.min << ',' << r.timeMs.median << ','
+                << r.timeMs.p95 << ',' << r.timeMs.mean << ',' << r.timeMs.stddev << ','
+                << r.gflops << ',' << r.residual << '\n';
+        }
+    }
+
+    void writeJson(std::ostream& out) const {
+        out << "{\n  \"warmup\": " << warmup_ << ",\n  \"trials\": " << trials_
+            << ",\n  \"results\": [\n";
+        for (size_t k = 0; k < records_.size(); k++) {
+            const BenchmarkRecord& r = records_[k];
+            out << "    {\"n\": " << r.n << ", \"threads\": " << r.threads << ", \"variant\": \""
+                << r.variant << "\", \"iterations\": " << r.iterations << ", \"time_ms\": {"
+                << "\"min\": " << r.timeMs.min << ", \"median\": " << r.timeMs.median
+                << ", \"p95\": " << r.timeMs.p95 << ", \"mean\": " << r.timeMs.mean
+                << ", \"stddev\": " << r.timeMs.stddev << "}, \"gflops\": " << r.gflops
+                << ", \"residual\": ";
+            // JSON has no inf/nan (a diverged solve)
+            if (std::isfinite(r.residual)) {
+                out << r.residual;
+            } else {
+                out << "null";
+            }
+            out << "}" << (k + 1 < records_.size() ? "," : "") << "\n";
+        }
+        out << "  ]";
+        for (const auto& section : sections_) {
+            out << ",\n  \"" << section.first << "\": " << section.second;
+        }
+        out << "\n}\n";
+    }
+
+    int warmup_;
+    int trials_;
+    std::vector<BenchmarkRecord> records_;
+    std::vector<std::pair<std::string, std::string>> sections_;
+};
+
+// "100,500,1000" -> {100, 500, 1000}; false on empty or non-positive entries
+inline bool parseIntList(const std::string& text, std::vector<int>& values) {
+    values.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        long v = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || v <= 0) {
+            return false;
+        }
+        values.push_back((int)v);
+    }
+    return !values.empty();
+}
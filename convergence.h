@@ -0,0 +1,103 @@
+/*
+ * Convergence Checking Policy
+ * Amortised max-diff checks: every k sweeps, or adaptively from the rate
+ *
+ * Skipping the check on most sweeps removes the diff computation and the
+ * global reduction from those sweeps, at the price of possibly running a
+ * few sweeps past the point where the tolerance was first met.
+ *
+ * The check measures either max |x_new - x| or the relative residual
+ * ||b - A x||_2 / ||b||_2. The residual needs no extra pass over A: the
+ * sweep forms A_i x for every row anyway, and the Jacobi update gives
+ *     b_i - A_i x = A_ii (x_new_i - x_i)
+ * so each row's residual is its update scaled by the diagonal. It is the
+ * residual of the iterate the sweep started from; the solution returned
+ * on convergence is one sweep further along.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+enum class StopCriterion {
+    MaxDiff,         // max |x_new - x| < tolerance
+    RelativeResidual // ||b - A x||_2 / ||b||_2 < tolerance
+};
+
+struct ConvergencePolicy {
+    int checkInterval = 1; // check every k sweeps (initial interval when adaptive)
+    bool adaptive = false; // pick the next interval from the observed rate
+    int maxInterval = 64;  // upper bound for adaptive intervals
+    StopCriterion criterion = StopCriterion::MaxDiff;
+};
+
+// Residual b_i - A_i x of row i, from the Jacobi update of that row
+inline double jacobiRowResidual(double xNew, double xOld, double diag) {
+    return diag * (xNew - xOld);
+}
+
+// ||b||_2 guarded for b = 0 (the relative residual is then the absolute one)
+inline double residualScale(double normB) { return normB > 0.0 ? normB : 1.0; }
+
+struct ConvergenceStats {
+    int checks = 0;               // number of sweeps that computed the max diff
+    double finalDiff = 0.0;       // measure of the criterion at the last check
+    double rate = 0.0;            // observed per-sweep contraction of the diff
+    int estimatedExtraSweeps = 0; // sweeps run after the tolerance was likely met
+};
+
+class ConvergenceMonitor {
+public:
+    ConvergenceMonitor(const ConvergencePolicy& policy, double tolerance)
+        : policy_(policy), tolerance_(tolerance),
+          interval_(std::max(1, policy.checkInterval)), nextCheck_(interval_) {}
+
+    // True if sweep number `sweep` (1-based) should compute the max diff
+    bool isCheckSweep(int sweep) const { return sweep >= nextCheck_; }
+
+    // Record the diff measured after `sweep` sweeps; returns true on convergence
+    bool record(int sweep, double diff) {
+        stats_.checks++;
+        if (lastSweep_ > 0 && lastDiff_ > 0.0 && diff > 0.0 && diff < lastDiff_) {
+            rate_ = std::pow(diff / lastDiff_, 1.0 / (sweep - lastSweep_));
+        }
+        int gap = sweep - lastSweep_;
+        lastSweep_ = sweep;
+        lastDiff_ = diff;
+        stats_.finalDiff = diff;
+        stats_.rate = rate_;
+
+        if (diff < tolerance_) {
+            // Sweeps since the diff would have crossed the tolerance, assuming
+            // geometric decay since the previous check
+            int extra = 0;
+            if (rate_ > 0.0 && rate_ < 1.0 && diff > 0.0) {
+                extra = (int)std::floor(std::log(tolerance_ / diff) / -std::log(rate_));
+                extra = std::max(0, std::min(extra, gap - 1));
+            }
+            stats_.estimatedExtraSweeps = extra;
+            return true;
+        }
+
+        if (policy_.adaptive && rate_ > 0.0 && rate_ < 1.0) {
+            // Check again about halfway to the predicted convergence point
+            double remaining = std::log(tolerance_ / diff) / std::log(rate_);
+            interval_ = std::max(1, std::min(policy_.maxInterval, (int)(remaining / 2.0)));
+        }
+        nextCheck_ = sweep + interval_;
+        return false;
+    }
+
+    const ConvergenceStats& stats() const { return stats_; }
+
+private:
+    ConvergencePolicy policy_;
+    double tolerance_;
+    int interval_;
+    int nextCheck_;
+    int lastSweep_ = 0;
+    double lastDiff_ = 0.0;
+    double rate_ = 0.0;
+    ConvergenceStats stats_;
+};
@@ -0,0 +1,169 @@
+/*
+ * Dense Matrix Storage
+ * Row-major matrix backed by a single aligned, contiguous buffer
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "memory_arena.h"
+
+// Lightweight view of one matrix row (pointer + length, no ownership)
+template <typename T>
+struct DenseRowView {
+    T* ptr;
+    int length;
+
+    T& operator[](int j) const { return ptr[j]; }
+    T* data() const { return ptr; }
+    int size() const { return length; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + length; }
+};
+
+// Dense row-major matrix with one aligned allocation from memoryArena()
+// (huge pages for large matrices under the arena's policy), templated on the
+// element type (DenseMatrix is the double version used by the solvers).
+// Each row starts on a cache-line boundary: the stride is the column count
+// rounded up to a multiple of kAlignment bytes, and the padding is zeroed so
+// SIMD kernels may safely read a full stride.
+// With firstTouchThreads > 0 the buffer is zeroed by that many OpenMP threads
+// using the solvers' schedule(static) row partition, so on NUMA systems each
+// thread's rows are placed on its own node (pages go to the first writer).
+template <typename T>
+class BasicDenseMatrix {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    BasicDenseMatrix() = default;
+
+    BasicDenseMatrix(int rows, int cols, int firstTouchThreads = 0)
+        : rows_(rows), cols_(cols), stride_(paddedStride(cols)) {
+        allocate(firstTouchThreads);
+    }
+
+    BasicDenseMatrix(const BasicDenseMatrix& other)
+        : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_) {
+        allocate();
+        if (data_ && other.data_) {
+            std::memcpy(data_, other.data_, bytes());
+        }
+    }
+
+    BasicDenseMatrix(BasicDenseMatrix&& other) noexcept { swap(other); }
+
+    // Wrap existing storage without copying (e.g. a memory-mapped file).
+    // `data` must be kAlignment-aligned with the padded stride and zeroed
+    // padding of an owned matrix; `owner` keeps the memory alive. Returns an
+    // empty matrix if the layout does not match.
+    static BasicDenseMatrix adopt(T* data, int rows, int cols, size_t stride,
+                                  std::shared_ptr<void> owner) {
+        BasicDenseMatrix m;
+        if (stride != paddedStride(cols) || (reinterpret_cast<uintptr_t>(data) % kAlignment) != 0) {
+            return m;
+        }
+        m.rows_ = rows;
+        m.cols_ = cols;
+        m.stride_ = stride;
+        m.data_ = data;
+        m.external_ = std::move(owner);
+        return m;
+    }
+
+    BasicDenseMatrix& operator=(BasicDenseMatrix other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~BasicDenseMatrix() { release(); }
+
+    bool empty() const { return data_ == nullptr; }
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    size_t stride() const { return stride_; }
+    size_t bytes() const { return (size_t)rows_ * stride_ * sizeof(T); }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    T* rowPtr(int i) { return data_ + (size_t)i * stride_; }
+    const T* rowPtr(int i) const { return data_ + (size_t)i * stride_; }
+
+    DenseRowView<T> row(int i) { return {rowPtr(i), cols_}; }
+    DenseRowView<const T> row(int i) const { return {rowPtr(i), cols_}; }
+
+    T& operator()(int i, int j) { return data_[(size_t)i * stride_ + j]; }
+    T operator()(int i, int j) const { return data_[(size_t)i * stride_ + j]; }
+
+    // Copy into the legacy vector-of-rows layout (used for storage comparison)
+    std::vector<std::vector<T>> toNested() const {
+        std::vector<std::vector<T>> nested(rows_, std::vector<T>(cols_));
+        for (int i = 0; i < rows_; i++) {
+            std::copy(rowPtr(i), rowPtr(i) + cols_, nested[i].begin());
+        }
+        return nested;
+    }
+
+    void swap(BasicDenseMatrix& other) noexcept {
+        std::swap(rows_, other.rows_);
+        std::swap(cols_, other.cols_);
+        std::swap(stride_, other.stride_);
+        std::swap(data_, other.data_);
+        std::swap(external_, other.external_);
+    }
+
+private:
+    static size_t paddedStride(int cols) {
+        const size_t perLine = kAlignment / sizeof(T);
+        return ((size_t)cols + perLine - 1) / perLine * perLine;
+    }
+
+    void allocate(int firstTouchThreads = 0) {
+        size_t size = bytes();
+        if (size == 0) {
+            return;
+        }
+        data_ = static_cast<T*>(memoryArena().allocate(size));
+        if (firstTouchThreads > 0) {
+#ifdef _OPENMP
+            const size_t rowBytes = stride_ * sizeof(T);
+            #pragma omp parallel for schedule(static) num_threads(firstTouchThreads)
+            for (int i = 0; i < rows_; i++) {
+                std::memset(data_ + (size_t)i * stride_, 0, rowBytes);
+            }
+#else
+            // Serial builds have one thread, which touches every row
+            std::memset(data_, 0, size);
+#endif
+        } else {
+            std::memset(data_, 0, size);
+        }
+    }
+
+    void release() {
+        if (external_) {
+            external_.reset();
+            data_ = nullptr;
+            return;
+        }
+        memoryArena().release(data_, bytes());
+        data_ = nullptr;
+    }
+
+    int rows_ = 0;
+    int cols_ = 0;
+    size_t stride_ = 0;
+    T* data_ = nullptr;
+    std::shared_ptr<void> external_; // set for adopted storage
+};
+
+using DenseMatrix = BasicDenseMatrix<double>;
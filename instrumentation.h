@@ -0,0 +1,292 @@
+/*
+ * Hot-Path Instrumentation
+ * Per-thread phase timers, hardware counters and a STREAM roofline
+ *
+ * Built with -DJACOBI_INSTRUMENT the solvers time their phases per thread:
+ *   sweep      the row loop of each thread
+ *   reduction  publishing / combining the max diff
+ *   copy       buffer swap (or copy) after a sweep
+ *   region     wall time of the parallel regions seen by the master thread;
+ *              region - (sweep + reduction) is fork/join plus barrier wait
+ * Without the flag the JACOBI_PHASE_* macros expand to nothing, so the
+ * solvers compile to exactly the uninstrumented code.
+ *
+ * HardwareCounters reads cycles, instructions and last-level cache misses
+ * through Linux perf_event (one counter group per OpenMP thread, summed);
+ * LLC misses x 64 bytes estimates the DRAM traffic. PAPI is not required.
+ * When perf_event is unavailable (other OS, perf_event_paranoid, containers)
+ * the counters report as unavailable and only the timers are shown.
+ * measureStreamTriad() gives the sustainable bandwidth that a memory-bound
+ * sweep is compared against.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum class Phase { Sweep, Reduction, Copy, Region, Count };
+
+inline const char* phaseName(Phase p) {
+    switch (p) {
+    case Phase::Sweep: return "sweep";
+    case Phase::Reduction: return "reduction";
+    case Phase::Copy: return "copy";
+    case Phase::Region: return "region";
+    default: return "?";
+    }
+}
+
+// Accumulated seconds per (thread, phase); one cache line per thread
+class PhaseProfile {
+public:
+    void reset(int numThreads) {
+        slots_.assign(std::max(1, numThreads), Slot());
+    }
+
+    void add(Phase p, double seconds) {
+        if (slots_.empty()) {
+            return;
+        }
+        Slot& s = slots_[omp_get_thread_num() % slots_.size()];
+        s.seconds[(int)p] += seconds;
+        s.calls[(int)p]++;
+    }
+
+    double mean(Phase p) const { return total(p) / activeThreads(p); }
+
+    double max(Phase p) const {
+        double m = 0.0;
+        for (const Slot& s : slots_) {
+            m = std::max(m, s.seconds[(int)p]);
+        }
+        return m;
+    }
+
+    double total(Phase p) const {
+        double t = 0.0;
+        for (const Slot& s : slots_) {
+            t += s.seconds[(int)p];
+        }
+        return t;
+    }
+
+    void print(std::ostream& os) const {
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::fixed << std::setprecision(3);
+        os << std::setw(14) << "Phase" << std::setw(14) << "Mean (ms)" << std::setw(14)
+           << "Max (ms)" << std::setw(10) << "Threads" << std::endl;
+        for (Phase p : {Phase::Sweep, Phase::Reduction, Phase::Copy, Phase::Region}) {
+            os << std::setw(14) << phaseName(p) << std::setw(14) << mean(p) * 1000.0
+               << std::setw(14) << max(p) * 1000.0 << std::setw(10) << activeThreads(p)
+               << std::endl;
+        }
+        double overhead = max(Phase::Region) - mean(Phase::Sweep) - mean(Phase::Reduction);
+        os << std::setw(14) << "fork/join+wait" << std::setw(14) << std::max(0.0, overhead) * 1000.0
+           << std::endl;
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+private:
+    static constexpr int kPhases = (int)Phase::Count;
+
+    int activeThreads(Phase p) const {
+        int count = 0;
+        for (const Slot& s : slots_) {
+            count += s.calls[(int)p] > 0;
+        }
+        return std::max(1, count);
+    }
+
+    struct alignas(64) Slot {
+        double seconds[kPhases] = {};
+        long long calls[kPhases] = {};
+    };
+
+    std::vector<Slot> slots_;
+};
+
+// Process-wide profile the instrumented solvers record into
+inline PhaseProfile& activeProfile() {
+    static PhaseProfile profile;
+    return profile;
+}
+
+#ifdef JACOBI_INSTRUMENT
+#define JACOBI_PHASE_START(name) double name = omp_get_wtime()
+#define JACOBI_PHASE_STOP(phase, name) activeProfile().add(phase, omp_get_wtime() - (name))
+#else
+#define JACOBI_PHASE_START(name) ((void)0)
+#define JACOBI_PHASE_STOP(phase, name) ((void)0)
+#endif
+
+inline bool instrumentationEnabled() {
+#ifdef JACOBI_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+struct CounterValues {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llcMisses = 0;
+
+    double bytesFromMemory() const { return 64.0 * (double)llcMisses; }
+};
+
+// perf_event counter groups of the first numThreads OpenMP threads. The
+// runtime reuses its OS threads for later teams of the same size, so
+// counters opened in one region keep counting the solver's regions.
+class HardwareCounters {
+public:
+    explicit HardwareCounters(int numThreads) : fds_(std::max(1, numThreads)) {
+#if defined(__linux__)
+        bool ok = true;
+        #pragma omp parallel num_threads((int)fds_.size()) reduction(&&:ok)
+        {
+            Group& g = fds_[omp_get_thread_num()];
+            g.leader = open(PERF_COUNT_HW_CPU_CYCLES, -1);
+            g.instructions = open(PERF_COUNT_HW_INSTRUCTIONS, g.leader);
+            g.misses = open(PERF_COUNT_HW_CACHE_MISSES, g.leader);
+            ok = g.leader >= 0 && g.instructions >= 0 && g.misses >= 0;
+        }
+        available_ = ok;
+        if (!ok) {
+            error_ = std::string("perf_event_open failed (") + std::strerror(errno) + ")";
+            closeAll();
+        }
+#else
+        error_ = "perf_event is Linux-only";
+#endif
+    }
+
+    ~HardwareCounters() { closeAll(); }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    bool available() const { return available_; }
+    const std::string& error() const { return error_; }
+
+    void start() { control(true); }
+
+    // Stop counting and return the sum over all threads
+    CounterValues stop() {
+        control(false);
+        CounterValues total;
+#if defined(__linux__)
+        for (const Group& g : fds_) {
+            if (g.leader < 0) {
+                continue;
+            }
+            // PERF_FORMAT_GROUP: {nr, value[nr]}
+            uint64_t buf[4] = {};
+            if (read(g.leader, buf, sizeof(buf)) == (ssize_t)sizeof(buf) && buf[0] == 3) {
+                total.cycles += buf[1];
+                total.instructions += buf[2];
+                total.llcMisses += buf[3];
+            }
+        }
+#endif
+        return total;
+    }
+
+private:
+    struct Group {
+        int leader = -1;
+        int instructions = -1;
+        int misses = -1;
+    };
+
+#if defined(__linux__)
+    static int open(uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = groupFd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+    }
+#endif
+
+    void control(bool enable) {
+#if defined(__linux__)
+        if (!available_) {
+            return;
+        }
+        for (const Group& g : fds_) {
+            if (enable) {
+                ioctl(g.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(g.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            } else {
+                ioctl(g.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            }
+        }
+#else
+        (void)enable;
+#endif
+    }
+
+    void closeAll() {
+#if defined(__linux__)
+        for (Group& g : fds_) {
+            for (int* fd : {&g.misses, &g.instructions, &g.leader}) {
+                if (*fd >= 0) {
+                    close(*fd);
+                    *fd = -1;
+                }
+            }
+        }
+#endif
+    }
+
+    std::vector<Group> fds_;
+    bool available_ = false;
+    std::string error_;
+};
+
+// STREAM triad a = b + s * c over `elements` doubles per array; returns the
+// best GB/s of `repeats` runs, counting 24 bytes per element as STREAM does
+inline double measureStreamTriad(int numThreads, size_t elements = (size_t)1 << 24,
+                                 int repeats = 5) {
+    std::vector<double> a(elements), b(elements), c(elements);
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (long long i = 0; i < (long long)elements; i++) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+    const double s = 3.0;
+    double best = 0.0;
+    for (int r = 0; r < repeats; r++) {
+        double start = omp_get_wtime();
+        #pragma omp parallel for schedule(static) num_threads(numThreads)
+        for (long long i = 0; i < (long long)elements; i++) {
+            a[i] = b[i] + s * c[i];
+        }
+        double elapsed = omp_get_wtime() - start;
+        best = std::max(best, 24.0 * (double)elements / (elapsed * 1.0e9));
+    }
+    return a[elements / 2] == 7.0 ? best : 0.0;
+}
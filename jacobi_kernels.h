@@ -0,0 +1,171 @@
+/*
+ * Jacobi Row Kernels
+ * Branch-free row dot products with explicit SIMD paths and runtime dispatch
+ *
+ * The Jacobi update for row i is computed as a full dot product plus a
+ * diagonal correction, so the inner loop has no j != i test:
+ *     sigma = dot(A[i], x) - A[i][i] * x[i]
+ */
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JACOBI_HAVE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define JACOBI_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+typedef double (*RowDotFn)(const double* a, const double* x, int n);
+
+struct RowDotKernel {
+    const char* name;
+    RowDotFn fn;
+};
+
+// Portable reference kernel (four accumulators to hide FMA latency)
+inline double rowDotScalar(const double* a, const double* x, int n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        s0 += a[j] * x[j];
+        s1 += a[j + 1] * x[j + 1];
+        s2 += a[j + 2] * x[j + 2];
+        s3 += a[j + 3] * x[j + 3];
+    }
+    for (; j < n; j++) {
+        s0 += a[j] * x[j];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+__attribute__((target("avx2,fma")))
+inline double rowDotAvx2(const double* a, const double* x, int n) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd();
+    __m256d acc3 = _mm256_setzero_pd();
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(x + j), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j + 4), _mm256_loadu_pd(x + j + 4), acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j + 8), _mm256_loadu_pd(x + j + 8), acc2);
+        acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j + 12), _mm256_loadu_pd(x + j + 12), acc3);
+    }
+    for (; j + 4 <= n; j += 4) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(x + j), acc0);
+    }
+    __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    __m128d lo = _mm256_castpd256_pd128(acc);
+    __m128d hi = _mm256_extractf128_pd(acc, 1);
+    lo = _mm_add_pd(lo, hi);
+    double sum = _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    for (; j < n; j++) {
+        sum += a[j] * x[j];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+inline double rowDotAvx512(const double* a, const double* x, int n) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd();
+    __m512d acc3 = _mm512_setzero_pd();
+    int j = 0;
+    for (; j + 32 <= n; j += 32) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(x + j), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + j + 8), _mm512_loadu_pd(x + j + 8), acc1);
+        acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + j + 16), _mm512_loadu_pd(x + j + 16), acc2);
+        acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + j + 24), _mm512_loadu_pd(x + j + 24), acc3);
+    }
+    for (; j + 8 <= n; j += 8) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(x + j), acc0);
+    }
+    if (j < n) {
+        __mmask8 mask = (__mmask8)((1u << (n - j)) - 1u);
+        acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + j),
+                               _mm512_maskz_loadu_pd(mask, x + j), acc1);
+    }
+    __m512d acc = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, acc);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+#endif
+
+#ifdef JACOBI_HAVE_NEON
+inline double rowDotNeon(const double* a, const double* x, int n) {
+    float64x2_t acc0 = vdupq_n_f64(0.0);
+    float64x2_t acc1 = vdupq_n_f64(0.0);
+    float64x2_t acc2 = vdupq_n_f64(0.0);
+    float64x2_t acc3 = vdupq_n_f64(0.0);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        acc0 = vfmaq_f64(acc0, vld1q_f64(a + j), vld1q_f64(x + j));
+        acc1 = vfmaq_f64(acc1, vld1q_f64(a + j + 2), vld1q_f64(x + j + 2));
+        acc2 = vfmaq_f64(acc2, vld1q_f64(a + j + 4), vld1q_f64(x + j + 4));
+        acc3 = vfmaq_f64(acc3, vld1q_f64(a + j + 6), vld1q_f64(x + j + 6));
+    }
+    for (; j + 2 <= n; j += 2) {
+        acc0 = vfmaq_f64(acc0, vld1q_f64(a + j), vld1q_f64(x + j));
+    }
+    float64x2_t acc = vaddq_f64(vaddq_f64(acc0, acc1), vaddq_f64(acc2, acc3));
+    double sum = vaddvq_f64(acc);
+    for (; j < n; j++) {
+        sum += a[j] * x[j];
+    }
+    return sum;
+}
+#endif
+
+// All kernels the current CPU can run, best first
+inline std::vector<RowDotKernel> availableRowDotKernels() {
+    std::vector<RowDotKernel> kernels;
+#ifdef JACOBI_HAVE_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels.push_back({"avx512", rowDotAvx512});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels.push_back({"avx2", rowDotAvx2});
+    }
+#endif
+#ifdef JACOBI_HAVE_NEON
+    kernels.push_back({"neon", rowDotNeon});
+#endif
+    kernels.push_back({"scalar", rowDotScalar});
+    return kernels;
+}
+
+// Look up a kernel by name; falls back to the best available one
+inline RowDotKernel findRowDotKernel(const char* name) {
+    std::vector<RowDotKernel> kernels = availableRowDotKernels();
+    for (const RowDotKernel& k : kernels) {
+        if (name && std::strcmp(k.name, name) == 0) {
+            return k;
+        }
+    }
+    return kernels.front();
+}
+
+// Kernel chosen once at startup (best supported by the running CPU)
+inline const RowDotKernel& activeRowDotKernel() {
+    static const RowDotKernel kernel = availableRowDotKernels().front();
+    return kernel;
+}
+
+// Jacobi update for one row: (b_i - (dot(A_i, x) - A_ii * x_i)) / A_ii
+inline double jacobiRowUpdate(RowDotFn dot, const double* Ai, const double* x,
+                              double bi, int i, int n) {
+    double sigma = dot(Ai, x, n) - Ai[i] * x[i];
+    return (bi - sigma) / Ai[i];
+}
@@ -0,0 +1,602 @@
+/*
+ * Jacobi Iterative Method - MPI + OpenMP Hybrid Version
+ * Solves a system of linear equations Ax = b distributed by rows
+ *
+ * Dense systems: every rank owns a block of rows and a replicated x, which
+ * is reassembled with MPI_Iallgatherv after each sweep. While the gather is
+ * in flight, the next sweep's products with the locally owned columns are
+ * already computed.
+ * Sparse/stencil systems: every rank owns a block of CSR rows and exchanges
+ * only the halo entries its rows reference with neighbouring ranks. Interior
+ * rows are computed while the halo messages are in flight.
+ * Convergence: the global max diff uses MPI_Iallreduce and is tested one
+ * sweep later, so the reduction overlaps with the next sweep (at most one
+ * extra sweep is performed).
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include <mpi.h>
+#include <omp.h>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+#include "sparse_matrix.h"
+#include "counter_rng.h"
+
+using namespace std;
+
+// Contiguous block row partition of n rows over P ranks
+struct RowPartition {
+    vector<int> counts;
+    vector<int> offsets;
+
+    RowPartition(int n, int P) : counts(P), offsets(P + 1, 0) {
+        for (int r = 0; r < P; r++) {
+            offsets[r + 1] = (int)((long long)n * (r + 1) / P);
+            counts[r] = offsets[r + 1] - offsets[r];
+        }
+    }
+
+    int owner(int row) const {
+        return (int)(upper_bound(offsets.begin(), offsets.end(), row) - offsets.begin()) - 1;
+    }
+};
+
+// Initialize rows [rowBegin, rowEnd) of the system produced by initializeSystem.
+// The counter-based generator is keyed by the global (i, j), so every
+// partition yields exactly the same global matrix.
+void initializeSystemRows(DenseMatrix& A, vector<double>& b, int n, int rowBegin, int rowEnd,
+                          uint64_t seed = kSystemSeed) {
+    CounterRng matrixRng(RngStream::Matrix, seed);
+    CounterRng rhsRng(RngStream::Rhs, seed);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = rowBegin; i < rowEnd; i++) {
+        double* Ai = A.rowPtr(i - rowBegin);
+        double rowSum = 0.0;
+        for (int j = 0; j < n; j++) {
+            if (i != j) {
+                Ai[j] = (double)matrixRng.uniformInt(i, j, 10) / 10.0; // Small off-diagonal values
+                rowSum += fabs(Ai[j]);
+            }
+        }
+        // Make diagonal element dominant
+        Ai[i] = rowSum + (double)(matrixRng.uniformInt(i, i, 10) + 1);
+        b[i - rowBegin] = (double)rhsRng.uniformInt(i, 0, 100) / 10.0;
+    }
+}
+
+// Lagged non-blocking convergence test: the reduction started after sweep k
+// is completed after sweep k + 1
+class LaggedMaxReduction {
+public:
+    explicit LaggedMaxReduction(MPI_Comm comm) : comm_(comm) {}
+
+    ~LaggedMaxReduction() { finish(); }
+
+    // Complete the pending reduction (if any); true if it met the tolerance
+    bool converged(double tolerance) {
+        if (!pending_) {
+            return false;
+        }
+        MPI_Wait(&request_, MPI_STATUS_IGNORE);
+        pending_ = false;
+        return global_ < tolerance;
+    }
+
+    void start(double localMax) {
+        local_ = localMax;
+        MPI_Iallreduce(&local_, &global_, 1, MPI_DOUBLE, MPI_MAX, comm_, &request_);
+        pending_ = true;
+    }
+
+    void finish() {
+        if (pending_) {
+            MPI_Wait(&request_, MPI_STATUS_IGNORE);
+            pending_ = false;
+        }
+    }
+
+private:
+    MPI_Comm comm_;
+    MPI_Request request_ = MPI_REQUEST_NULL;
+    double local_ = 0.0;
+    double global_ = 0.0;
+    bool pending_ = false;
+};
+
+// Distributed dense Jacobi. A holds the local rows, x the full replicated
+// vector (updated in place on return).
+int jacobiDistributedDense(const DenseMatrix& A, const vector<double>& b, vector<double>& x,
+                           int n, const RowPartition& part, MPI_Comm comm,
+                           double tolerance, int maxIterations) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    const int r0 = part.offsets[rank];
+    const int r1 = part.offsets[rank + 1];
+    const int localRows = r1 - r0;
+    RowDotFn dot = activeRowDotKernel().fn;
+
+    vector<double> x_next(n, 0.0);
+    // New values of the local rows: the gather's send buffer, and what the
+    // overlapped part of the next sweep reads while x_next is in flight
+    vector<double> localNext(localRows, 0.0);
+    vector<double> ownPart(localRows, 0.0); // A_loc[:, r0:r1] . x[r0:r1]
+    LaggedMaxReduction check(comm);
+    int iterations = 0;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < localRows; i++) {
+        ownPart[i] = dot(A.rowPtr(i) + r0, x.data() + r0, localRows);
+    }
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+        double localMax = 0.0;
+
+        // Remaining columns, then the Jacobi update of the local rows
+        #pragma omp parallel for schedule(static) reduction(max:localMax)
+        for (int i = 0; i < localRows; i++) {
+            const double* Ai = A.rowPtr(i);
+            int gi = r0 + i;
+            double sum = ownPart[i] + dot(Ai, x.data(), r0) +
+                         dot(Ai + r1, x.data() + r1, n - r1);
+            double sigma = sum - Ai[gi] * x[gi];
+            localNext[i] = (b[i] - sigma) / Ai[gi];
+            localMax = max(localMax, fabs(localNext[i] - x[gi]));
+        }
+
+        // x_next belongs to the gather until MPI_Wait, so nothing below
+        // touches it before then
+        MPI_Request gather;
+        MPI_Iallgatherv(localNext.data(), localRows, MPI_DOUBLE, x_next.data(),
+                        part.counts.data(), part.offsets.data(), MPI_DOUBLE, comm, &gather);
+        bool stop = check.converged(tolerance);
+        check.start(localMax);
+
+        // Overlap: the locally owned part of the next sweep needs no remote data
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < localRows; i++) {
+            ownPart[i] = dot(A.rowPtr(i) + r0, localNext.data(), localRows);
+        }
+
+        MPI_Wait(&gather, MPI_STATUS_IGNORE);
+        x.swap(x_next);
+        iterations++;
+
+        if (stop) {
+            break;
+        }
+    }
+
+    check.finish();
+    return iterations;
+}
+
+// Local CSR rows with columns renumbered to [0, localRows) for owned entries
+// and [localRows, localRows + halo) for entries received from neighbours
+struct DistributedCsr {
+    CsrMatrix local;
+    vector<char> isBoundary;        // row references at least one halo column
+    vector<int> neighbors;          // ranks we exchange with
+    vector<int> recvCounts, recvOffsets;
+    vector<int> sendCounts, sendOffsets;
+    vector<int> sendIndices;        // local indices to pack for each neighbour
+    int haloSize = 0;
+};
+
+DistributedCsr buildDistributedCsr(CsrMatrix rows, const RowPartition& part, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    const int r0 = part.offsets[rank];
+    const int localRows = rows.n;
+
+    // Halo columns grouped by owning rank (sorted global index)
+    vector<int> halo;
+    for (int c : rows.colIdx) {
+        if (c < r0 || c >= r0 + localRows) {
+            halo.push_back(c);
+        }
+    }
+    sort(halo.begin(), halo.end());
+    halo.erase(unique(halo.begin(), halo.end()), halo.end());
+
+    DistributedCsr D;
+    D.haloSize = (int)halo.size();
+    D.isBoundary.assign(localRows, 0);
+    for (int i = 0; i < localRows; i++) {
+        for (int p = rows.rowPtr[i]; p < rows.rowPtr[i + 1]; p++) {
+            int c = rows.colIdx[p];
+            if (c >= r0 && c < r0 + localRows) {
+                rows.colIdx[p] = c - r0;
+            } else {
+                rows.colIdx[p] = localRows +
+                    (int)(lower_bound(halo.begin(), halo.end(), c) - halo.begin());
+                D.isBoundary[i] = 1;
+            }
+        }
+    }
+    D.local = std::move(rows);
+
+    // Tell every owner which of its entries we need (setup only)
+    vector<int> need(size, 0);
+    for (int c : halo) {
+        need[part.owner(c)]++;
+    }
+    vector<int> give(size, 0);
+    MPI_Alltoall(need.data(), 1, MPI_INT, give.data(), 1, MPI_INT, comm);
+
+    vector<MPI_Request> requests;
+    int haloOffset = 0;
+    for (int r = 0; r < size; r++) {
+        if (need[r] == 0 && give[r] == 0) {
+            continue;
+        }
+        D.neighbors.push_back(r);
+        D.recvOffsets.push_back(haloOffset);
+        D.recvCounts.push_back(need[r]);
+        haloOffset += need[r];
+        D.sendCounts.push_back(give[r]);
+    }
+    D.sendOffsets.assign(D.neighbors.size() + 1, 0);
+    for (size_t k = 0; k < D.neighbors.size(); k++) {
+        D.sendOffsets[k + 1] = D.sendOffsets[k] + D.sendCounts[k];
+    }
+    D.sendIndices.assign(D.sendOffsets.back(), 0);
+    for (size_t k = 0; k < D.neighbors.size(); k++) {
+        MPI_Request req;
+        if (D.recvCounts[k] > 0) {
+            MPI_Isend(halo.data() + D.recvOffsets[k], D.recvCounts[k], MPI_INT,
+                      D.neighbors[k], 0, comm, &req);
+            requests.push_back(req);
+        }
+        if (D.sendCounts[k] > 0) {
+            MPI_Irecv(D.sendIndices.data() + D.sendOffsets[k], D.sendCounts[k], MPI_INT,
+                      D.neighbors[k], 0, comm, &req);
+            requests.push_back(req);
+        }
+    }
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    for (int& idx : D.sendIndices) {
+        idx -= r0;
+    }
+    return D;
+}
+
+// Start the neighbour-only halo exchange of x (x has localRows + haloSize entries)
+void startHaloExchange(const DistributedCsr& D, vector<double>& x, vector<double>& sendBuf,
+                       vector<MPI_Request>& requests, MPI_Comm comm) {
+    requests.clear();
+    const int localRows = D.local.n;
+    for (size_t k = 0; k < D.neighbors.size(); k++) {
+        if (D.recvCounts[k] > 0) {
+            MPI_Request req;
+            MPI_Irecv(x.data() + localRows + D.recvOffsets[k], D.recvCounts[k], MPI_DOUBLE,
+                      D.neighbors[k], 1, comm, &req);
+            requests.push_back(req);
+        }
+    }
+    for (size_t k = 0; k < D.neighbors.size(); k++) {
+        if (D.sendCounts[k] > 0) {
+            for (int p = D.sendOffsets[k]; p < D.sendOffsets[k + 1]; p++) {
+                sendBuf[p] = x[D.sendIndices[p]];
+            }
+            MPI_Request req;
+            MPI_Isend(sendBuf.data() + D.sendOffsets[k], D.sendCounts[k], MPI_DOUBLE,
+                      D.neighbors[k], 1, comm, &req);
+            requests.push_back(req);
+        }
+    }
+}
+
+// Distributed sparse Jacobi; x holds the local rows on entry and on return
+int jacobiDistributedCsr(const DistributedCsr& D, const vector<double>& b, vector<double>& x,
+                         MPI_Comm comm, double tolerance, int maxIterations) {
+    const CsrMatrix& A = D.local;
+    const int localRows = A.n;
+    vector<double> cur(localRows + D.haloSize, 0.0), next(localRows + D.haloSize, 0.0);
+    copy(x.begin(), x.end(), cur.begin());
+    vector<double> sendBuf(D.sendIndices.size());
+    vector<MPI_Request> requests;
+    LaggedMaxReduction check(comm);
+    int iterations = 0;
+
+    auto updateRow = [&](int i) {
+        double sum = 0.0;
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; p++) {
+            sum += A.values[p] * cur[A.colIdx[p]];
+        }
+        double sigma = sum - A.diag[i] * cur[i];
+        next[i] = (b[i] - sigma) / A.diag[i];
+        return fabs(next[i] - cur[i]);
+    };
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+        startHaloExchange(D, cur, sendBuf, requests, comm);
+        double localMax = 0.0;
+
+        // Interior rows overlap with the halo messages
+        #pragma omp parallel for schedule(static) reduction(max:localMax)
+        for (int i = 0; i < localRows; i++) {
+            if (!D.isBoundary[i]) {
+                localMax = max(localMax, updateRow(i));
+            }
+        }
+
+        MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+        #pragma omp parallel for schedule(static) reduction(max:localMax)
+        for (int i = 0; i < localRows; i++) {
+            if (D.isBoundary[i]) {
+                localMax = max(localMax, updateRow(i));
+            }
+        }
+
+        bool stop = check.converged(tolerance);
+        check.start(localMax);
+        cur.swap(next);
+        iterations++;
+
+        if (stop) {
+            break;
+        }
+    }
+
+    check.finish();
+    copy(cur.begin(), cur.begin() + localRows, x.begin());
+    return iterations;
+}
+
+// Global residual ||Ax - b|| for the distributed dense system
+double computeResidualDense(const DenseMatrix& A, const vector<double>& b,
+                            const vector<double>& x, int n, int localRows, MPI_Comm comm) {
+    double local = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:local)
+    for (int i = 0; i < localRows; i++) {
+        const double* Ai = A.rowPtr(i);
+        double sum = 0.0;
+        for (int j = 0; j < n; j++) {
+            sum += Ai[j] * x[j];
+        }
+        local += (sum - b[i]) * (sum - b[i]);
+    }
+    double global = 0.0;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+    return sqrt(global);
+}
+
+// Global residual ||Ax - b|| for the distributed sparse system
+double computeResidualCsr(const DistributedCsr& D, const vector<double>& b,
+                          const vector<double>& x, MPI_Comm comm) {
+    const CsrMatrix& A = D.local;
+    vector<double> ext(A.n + D.haloSize, 0.0);
+    copy(x.begin(), x.end(), ext.begin());
+    vector<double> sendBuf(D.sendIndices.size());
+    vector<MPI_Request> requests;
+    startHaloExchange(D, ext, sendBuf, requests, comm);
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+    double local = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:local)
+    for (int i = 0; i < A.n; i++) {
+        double sum = 0.0;
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; p++) {
+            sum += A.values[p] * ext[A.colIdx[p]];
+        }
+        local += (sum - b[i]) * (sum - b[i]);
+    }
+    double global = 0.0;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+    return sqrt(global);
+}
+
+struct RunResult {
+    int iterations;
+    double timeMs;
+    double residual;
+};
+
+// Solve the dense system of size n on communicator comm
+RunResult runDense(int n, MPI_Comm comm, double tolerance, int maxIterations) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    RowPartition part(n, size);
+    int r0 = part.offsets[rank], r1 = part.offsets[rank + 1];
+
+    DenseMatrix A(r1 - r0, n);
+    vector<double> b(r1 - r0);
+    initializeSystemRows(A, b, n, r0, r1);
+    vector<double> x(n, 0.0);
+
+    MPI_Barrier(comm);
+    double start = MPI_Wtime();
+    int iterations = jacobiDistributedDense(A, b, x, n, part, comm, tolerance, maxIterations);
+    double elapsed = MPI_Wtime() - start, slowest = 0.0;
+    MPI_Allreduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    double residual = computeResidualDense(A, b, x, n, r1 - r0, comm);
+    return {iterations, slowest * 1000.0, residual};
+}
+
+// Solve the stencil system on an nx * ny * nz grid on communicator comm
+RunResult runStencil(int nx, int ny, int nz, MPI_Comm comm, double tolerance, int maxIterations) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    int n = nx * ny * nz;
+    RowPartition part(n, size);
+
+    CsrMatrix rows;
+    vector<double> b;
+    initializeStencilRows(rows, b, nx, ny, nz, part.offsets[rank], part.offsets[rank + 1]);
+    DistributedCsr D = buildDistributedCsr(std::move(rows), part, comm);
+    vector<double> x(D.local.n, 0.0);
+
+    MPI_Barrier(comm);
+    double start = MPI_Wtime();
+    int iterations = jacobiDistributedCsr(D, b, x, comm, tolerance, maxIterations);
+    double elapsed = MPI_Wtime() - start, slowest = 0.0;
+    MPI_Allreduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    double residual = computeResidualCsr(D, b, x, comm);
+    return {iterations, slowest * 1000.0, residual};
+}
+
+// Rank counts used for the scaling tables: 1, 2, 4, ... and the full world
+vector<int> scalingRankCounts(int worldSize) {
+    vector<int> counts;
+    for (int p = 1; p < worldSize; p *= 2) {
+        counts.push_back(p);
+    }
+    counts.push_back(worldSize);
+    return counts;
+}
+
+// Run `solve` on the first p ranks for every p; results are valid on world rank 0
+template <typename Solve>
+vector<RunResult> runScaling(const vector<int>& rankCounts, Solve solve) {
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    vector<RunResult> results;
+    for (int p : rankCounts) {
+        MPI_Comm comm;
+        MPI_Comm_split(MPI_COMM_WORLD, worldRank < p ? 0 : MPI_UNDEFINED, worldRank, &comm);
+        RunResult r = {0, 0.0, 0.0};
+        if (comm != MPI_COMM_NULL) {
+            r = solve(p, comm);
+            MPI_Comm_free(&comm);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        results.push_back(r);
+    }
+    return results;
+}
+
+// Print in the Threads/Time/Speedup/Efficiency layout used by jacobi_parallel.
+// Weak-scaling tables report time per sweep, because the iteration count
+// changes with the problem size; their speedup is the scaled p * T1 / Tp.
+void printScalingTable(const vector<int>& rankCounts, const vector<RunResult>& results,
+                       bool weak) {
+    cout << "-----------------------------------------------------" << endl;
+    cout << setw(10) << "Ranks" << setw(15) << (weak ? "ms/iter" : "Time (ms)")
+         << setw(12) << "Speedup" << setw(15) << "Efficiency" << endl;
+    cout << "-----------------------------------------------------" << endl;
+    for (size_t k = 0; k < rankCounts.size(); k++) {
+        int p = rankCounts[k];
+        double timeMs = results[k].timeMs;
+        double baseMs = results[0].timeMs;
+        if (weak) {
+            timeMs /= max(results[k].iterations, 1);
+            baseMs /= max(results[0].iterations, 1);
+        }
+        double speedup = baseMs / timeMs;
+        double efficiency = speedup / p;
+        if (weak) {
+            efficiency = baseMs / timeMs;
+            speedup = p * efficiency;
+        }
+        cout << setw(10) << p
+             << setw(15) << timeMs
+             << setw(12) << setprecision(2) << speedup
+             << setw(14) << efficiency * 100.0 << "%" << setprecision(6) << endl;
+    }
+}
+
+void printBaseline(const RunResult& r, int threadsPerRank) {
+    cout << "\nSequential: (1 rank, " << threadsPerRank << " threads)" << endl;
+    cout << "  Iterations: " << r.iterations << endl;
+    cout << "  Time: " << r.timeMs << " ms" << endl;
+    cout << "  Residual: " << scientific << r.residual << fixed << endl;
+}
+
+int main(int argc, char** argv) {
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int worldRank, worldSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+
+    // Problem sizes to test
+    vector<int> denseSizes = {1000, 2000};
+    int denseWeakBase = 1000;             // n for one rank; n grows with sqrt(ranks)
+    int gridNx = 1024, gridNy = 1024;     // strong-scaling 2D stencil
+    int weakRowsPerRank = 256;            // grid lines per rank for weak scaling
+    double tolerance = 1e-6;
+    int maxIterations = 10000;
+    int threadsPerRank = omp_get_max_threads();
+    vector<int> rankCounts = scalingRankCounts(worldSize);
+    bool root = (worldRank == 0);
+
+    if (root) {
+        cout << "=============================================" << endl;
+        cout << "  Jacobi Iterative Method - MPI + OpenMP" << endl;
+        cout << "=============================================" << endl;
+        cout << "MPI ranks: " << worldSize << endl;
+        cout << "OpenMP threads per rank: " << threadsPerRank << endl;
+        cout << "Row kernel: " << activeRowDotKernel().name << endl;
+        cout << fixed << setprecision(6);
+    }
+
+    // Dense strong scaling (MPI_Iallgatherv of x)
+    for (int n : denseSizes) {
+        vector<RunResult> results = runScaling(rankCounts, [&](int, MPI_Comm comm) {
+            return runDense(n, comm, tolerance, maxIterations);
+        });
+        if (root) {
+            cout << "\n=====================================================" << endl;
+            cout << "Matrix size: " << n << " x " << n << endl;
+            cout << "=====================================================" << endl;
+            printBaseline(results[0], threadsPerRank);
+            cout << "\nParallel (MPI + OpenMP, dense, strong scaling):" << endl;
+            printScalingTable(rankCounts, results, false);
+        }
+    }
+
+    // Sparse stencil strong scaling (neighbour halo exchange)
+    {
+        int n = gridNx * gridNy;
+        vector<RunResult> results = runScaling(rankCounts, [&](int, MPI_Comm comm) {
+            return runStencil(gridNx, gridNy, 1, comm, tolerance, maxIterations);
+        });
+        if (root) {
+            cout << "\n=====================================================" << endl;
+            cout << "Matrix size: " << n << " x " << n << " (2D 5-point stencil, CSR)" << endl;
+            cout << "=====================================================" << endl;
+            printBaseline(results[0], threadsPerRank);
+            cout << "\nParallel (MPI + OpenMP, sparse halo exchange, strong scaling):" << endl;
+            printScalingTable(rankCounts, results, false);
+        }
+    }
+
+    // Weak scaling: fixed work per rank
+    {
+        vector<RunResult> dense = runScaling(rankCounts, [&](int p, MPI_Comm comm) {
+            int n = (int)(denseWeakBase * sqrt((double)p));
+            return runDense(n, comm, tolerance, maxIterations);
+        });
+        vector<RunResult> sparse = runScaling(rankCounts, [&](int p, MPI_Comm comm) {
+            return runStencil(gridNx, weakRowsPerRank * p, 1, comm, tolerance, maxIterations);
+        });
+        if (root) {
+            cout << "\n=====================================================" << endl;
+            cout << "Weak scaling" << endl;
+            cout << "=====================================================" << endl;
+            cout << "\nDense, n = " << denseWeakBase << " * sqrt(ranks):" << endl;
+            printScalingTable(rankCounts, dense, true);
+            cout << "\nStencil, " << gridNx << " x (" << weakRowsPerRank << " * ranks) grid:" << endl;
+            printScalingTable(rankCounts, sparse, true);
+        }
+    }
+
+    if (root) {
+        cout << "\n=============================================" << endl;
+    }
+
+    MPI_Finalize();
+    return 0;
+}
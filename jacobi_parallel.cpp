@@ -7,29 +7,71 @@
 #include <vector>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <omp.h>
 
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+#include "sparse_jacobi.h"
+#include "stencil_jacobi.h"
+#include "thread_reduction.h"
+#include "convergence.h"
+#include "relaxation.h"
+#include "jacobi_device.h"
+#include "thread_affinity.h"
+#include "counter_rng.h"
+#include "matrix_io.h"
+#include "mixed_precision.h"
+#include "batched_jacobi.h"
+#include "jacobi_solver.h"
+#include "jacobi_split.h"
+#include "tiled_jacobi.h"
+#include "autotune.h"
+#include "benchmark_harness.h"
+#include "instrumentation.h"
+#include "scaling_model.h"
+#include "async_jacobi.h"
+#include "row_scheduler.h"
+#include "memory_arena.h"
+#include "small_jacobi.h"
+#include "system_batch.h"
+#include "solve_progress.h"
+
 using namespace std;
 
-// Function to initialize a diagonally dominant matrix (ensures convergence)
-void initializeSystem(vector<vector<double>>& A, vector<double>& b, int n) {
+// Function to initialize a diagonally dominant matrix (ensures convergence).
+// Entries come from the counter-based generator keyed by (seed, i, j), so rows
+// are filled in parallel and the system is the same for any thread count.
+void initializeSystem(DenseMatrix& A, vector<double>& b, int n, uint64_t seed = kSystemSeed) {
+    CounterRng matrixRng(RngStream::Matrix, seed);
+    CounterRng rhsRng(RngStream::Rhs, seed);
+    
     // Create a diagonally dominant matrix for convergence
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < n; i++) {
+        double* Ai = A.rowPtr(i);
         double rowSum = 0.0;
         for (int j = 0; j < n; j++) {
             if (i != j) {
-                A[i][j] = (double)(rand() % 10) / 10.0; // Small off-diagonal values
-                rowSum += fabs(A[i][j]);
+                Ai[j] = (double)matrixRng.uniformInt(i, j, 10) / 10.0; // Small off-diagonal values
+                rowSum += fabs(Ai[j]);
             }
         }
         // Make diagonal element dominant
-        A[i][i] = rowSum + (double)(rand() % 10 + 1);
-        b[i] = (double)(rand() % 100) / 10.0;
+        Ai[i] = rowSum + (double)(matrixRng.uniformInt(i, i, 10) + 1);
+        b[i] = (double)rhsRng.uniformInt(i, 0, 100) / 10.0;
     }
 }
 
 // Sequential Jacobi Iterative Method (for comparison)
-int jacobiSequential(const vector<vector<double>>& A, const vector<double>& b,
+int jacobiSequential(const DenseMatrix& A, const vector<double>& b,
                      vector<double>& x, int n, double tolerance, int maxIterations) {
     vector<double> x_new(n, 0.0);
     int iterations = 0;
@@ -38,23 +80,56 @@ int jacobiSequential(const vector<vector<double>>& A, const vector<double>& b,
         double maxDiff = 0.0;
         
         for (int i = 0; i < n; i++) {
+            const double* Ai = A.rowPtr(i);
             double sigma = 0.0;
             for (int j = 0; j < n; j++) {
                 if (j != i) {
-                    sigma += A[i][j] * x[j];
+                    sigma += Ai[j] * x[j];
                 }
             }
-            x_new[i] = (b[i] - sigma) / A[i][i];
+            x_new[i] = (b[i] - sigma) / Ai[i];
             double diff = fabs(x_new[i] - x[i]);
             if (diff > maxDiff) {
                 maxDiff = diff;
             }
         }
         
+        // Swap buffers: x_new becomes the current iterate, no copy pass
+        x.swap(x_new);
+        
+        iterations++;
+        if (maxDiff < tolerance) {
+            break;
+        }
+    }
+    
+    return iterations;
+}
+
+// Sequential Jacobi on the split form A = D + R: no branch, no division
+int jacobiSequential(const DenseSplit& S, const vector<double>& b,
+                     vector<double>& x, int n, double tolerance, int maxIterations) {
+    vector<double> x_new(n, 0.0);
+    int iterations = 0;
+    
+    for (int iter = 0; iter < maxIterations; iter++) {
+        double maxDiff = 0.0;
+        
         for (int i = 0; i < n; i++) {
-            x[i] = x_new[i];
+            const double* Ri = S.R.rowPtr(i);
+            double sigma = 0.0;
+            for (int j = 0; j < n; j++) {
+                sigma += Ri[j] * x[j];
+            }
+            x_new[i] = jacobiSplitUpdate(sigma, b[i], S.invDiag[i]);
+            double diff = fabs(x_new[i] - x[i]);
+            if (diff > maxDiff) {
+                maxDiff = diff;
+            }
         }
         
+        x.swap(x_new);
+        
         iterations++;
         if (maxDiff < tolerance) {
             break;
@@ -65,9 +140,272 @@ int jacobiSequential(const vector<vector<double>>& A, const vector<double>& b,
 }
 
 // Parallel Jacobi Iterative Method using OpenMP
-int jacobiParallel(const vector<vector<double>>& A, const vector<double>& b,
+// `policy` controls how often the max-diff convergence check runs; sweeps
+// that skip it do no diff computation and no reduction. If `stats` is given
+// it receives the number of checks and the estimated extra sweeps. An
+// `observer` sees the iterate after every check sweep, between regions.
+int jacobiParallel(const DenseMatrix& A, const vector<double>& b,
+                   vector<double>& x, int n, double tolerance, int maxIterations,
+                   int numThreads, const ConvergencePolicy& policy = ConvergencePolicy(),
+                   ConvergenceStats* stats = nullptr, SolveObserver* observer = nullptr) {
+    vector<double> x_new(n, 0.0);
+    int iterations = 0;
+    RowDotFn dot = activeRowDotKernel().fn;
+    
+    omp_set_num_threads(numThreads);
+    
+    // Padded per-thread max-diff and residual slots, allocated once per solve
+    ThreadReducer maxDiffReducer(numThreads);
+    ThreadReducer residualReducer(numThreads);
+    ConvergenceMonitor monitor(policy, tolerance);
+    const bool residualStop = policy.criterion == StopCriterion::RelativeResidual;
+    const double normB = residualStop ? residualScale(parallelNorm2(b.data(), n, residualReducer))
+                                      : 1.0;
+    if (observer) {
+        observer->start();
+    }
+    
+    for (int iter = 0; iter < maxIterations; iter++) {
+        const double* xCur = x.data();
+        double* xNext = x_new.data();
+        bool check = monitor.isCheckSweep(iter + 1);
+        
+        JACOBI_PHASE_START(regionStart);
+        if (check) {
+            maxDiffReducer.reset(0.0);
+            residualReducer.reset(0.0);
+            
+            // Parallel region for computing new values; the convergence diff is
+            // fused into the same sweep so x is read once and x_new written once
+            #pragma omp parallel
+            {
+                // Running max and residual stay in registers; published once
+                double localMax = 0.0;
+                double localResidual = 0.0;
+                
+                JACOBI_PHASE_START(sweepStart);
+                #pragma omp for schedule(static) nowait
+                for (int i = 0; i < n; i++) {
+                    // Branch-free: full row dot product minus the diagonal term
+                    const double* Ai = A.rowPtr(i);
+                    xNext[i] = jacobiRowUpdate(dot, Ai, xCur, b[i], i, n);
+                    
+                    // Track maximum difference for convergence check
+                    double diff = fabs(xNext[i] - xCur[i]);
+                    if (diff > localMax) {
+                        localMax = diff;
+                    }
+                    double r = jacobiRowResidual(xNext[i], xCur[i], Ai[i]);
+                    localResidual += r * r;
+                }
+                JACOBI_PHASE_STOP(Phase::Sweep, sweepStart);
+                
+                JACOBI_PHASE_START(reduceStart);
+                maxDiffReducer.publishMax(localMax);
+                residualReducer.publishSum(localResidual);
+                JACOBI_PHASE_STOP(Phase::Reduction, reduceStart);
+            }
+        } else {
+            // Update-only sweep: no diff, no reduction
+            #pragma omp parallel
+            {
+                JACOBI_PHASE_START(sweepStart);
+                #pragma omp for schedule(static) nowait
+                for (int i = 0; i < n; i++) {
+                    xNext[i] = jacobiRowUpdate(dot, A.rowPtr(i), xCur, b[i], i, n);
+                }
+                JACOBI_PHASE_STOP(Phase::Sweep, sweepStart);
+            }
+        }
+        JACOBI_PHASE_STOP(Phase::Region, regionStart);
+        
+        // Swap buffers instead of copying x_new back into x; the caller's
+        // vector always ends up owning the latest iterate
+        JACOBI_PHASE_START(copyStart);
+        x.swap(x_new);
+        JACOBI_PHASE_STOP(Phase::Copy, copyStart);
+        
+        iterations++;
+        
+        // Check for convergence (combine partial results from all threads)
+        JACOBI_PHASE_START(combineStart);
+        bool done = false;
+        if (check) {
+            double measure = residualStop ? sqrt(residualReducer.sum()) / normB
+                                          : maxDiffReducer.max();
+            done = monitor.record(iterations, measure);
+            if (observer) {
+                observer->observe(iterations, measure, x.data(), n);
+            }
+        }
+        JACOBI_PHASE_STOP(Phase::Reduction, combineStart);
+        if (done) {
+            break;
+        }
+    }
+    
+    if (stats) {
+        *stats = monitor.stats();
+    }
+    if (observer) {
+        observer->finish(iterations, monitor.stats().finalDiff, x.data(), n);
+    }
+    
+    return iterations;
+}
+
+// Parallel Jacobi on the split form: each row is one SIMD dot product with
+// the off-diagonal part R and a multiply by the cached 1/A_ii
+int jacobiParallel(const DenseSplit& S, const vector<double>& b,
                    vector<double>& x, int n, double tolerance, int maxIterations,
-                   int numThreads) {
+                   int numThreads, const ConvergencePolicy& policy = ConvergencePolicy(),
+                   ConvergenceStats* stats = nullptr) {
+    vector<double> x_new(n, 0.0);
+    int iterations = 0;
+    RowDotFn dot = activeRowDotKernel().fn;
+    const double* invDiag = S.invDiag.data();
+    
+    omp_set_num_threads(numThreads);
+    
+    ThreadReducer maxDiffReducer(numThreads);
+    ThreadReducer residualReducer(numThreads);
+    ConvergenceMonitor monitor(policy, tolerance);
+    const bool residualStop = policy.criterion == StopCriterion::RelativeResidual;
+    const double normB = residualStop ? residualScale(parallelNorm2(b.data(), n, residualReducer))
+                                      : 1.0;
+    
+    for (int iter = 0; iter < maxIterations; iter++) {
+        const double* xCur = x.data();
+        double* xNext = x_new.data();
+        bool check = monitor.isCheckSweep(iter + 1);
+        
+        if (check) {
+            maxDiffReducer.reset(0.0);
+            residualReducer.reset(0.0);
+            
+            #pragma omp parallel
+            {
+                double localMax = 0.0;
+                double localResidual = 0.0;
+                
+                #pragma omp for schedule(static) nowait
+                for (int i = 0; i < n; i++) {
+                    xNext[i] = jacobiSplitUpdate(dot(S.R.rowPtr(i), xCur, n), b[i], invDiag[i]);
+                    double diff = fabs(xNext[i] - xCur[i]);
+                    if (diff > localMax) {
+                        localMax = diff;
+                    }
+                    double r = (xNext[i] - xCur[i]) / invDiag[i];
+                    localResidual += r * r;
+                }
+                
+                maxDiffReducer.publishMax(localMax);
+                residualReducer.publishSum(localResidual);
+            }
+        } else {
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; i++) {
+                xNext[i] = jacobiSplitUpdate(dot(S.R.rowPtr(i), xCur, n), b[i], invDiag[i]);
+            }
+        }
+        
+        x.swap(x_new);
+        
+        iterations++;
+        
+        if (check && monitor.record(iterations, residualStop
+                                                    ? sqrt(residualReducer.sum()) / normB
+                                                    : maxDiffReducer.max())) {
+            break;
+        }
+    }
+    
+    if (stats) {
+        *stats = monitor.stats();
+    }
+    
+    return iterations;
+}
+
+// Parallel Jacobi with one persistent OpenMP region for the whole solve.
+// Each sweep is an `omp for` whose implicit barrier is the only barrier of
+// the iteration: x and x_new swap roles by pointer, so there is no copy
+// phase, and the max-diff reduction rotates over three shared slots so the
+// slot for the next sweep can be reset without an extra barrier (slot k%3 is
+// reduced in sweep k; slot (k+1)%3 was last read before barrier k-1).
+int jacobiParallelPersistent(const DenseMatrix& A, const vector<double>& b,
+                             vector<double>& x, int n, double tolerance, int maxIterations,
+                             int numThreads) {
+    vector<double> x_new(n, 0.0);
+    RowDotFn dot = activeRowDotKernel().fn;
+    double diff0 = 0.0, diff1 = 0.0, diff2 = 0.0;
+    int iterations = 0;
+    const double* finalX = x.data();
+    
+    #pragma omp parallel num_threads(numThreads)
+    {
+        double* cur = x.data();
+        double* next = x_new.data();
+        int iter = 0;
+        
+        while (iter < maxIterations) {
+            int slot = iter % 3;
+            
+            #pragma omp master
+            {
+                double& upcoming = (slot == 0) ? diff1 : (slot == 1) ? diff2 : diff0;
+                upcoming = 0.0;
+            }
+            
+            if (slot == 0) {
+                #pragma omp for schedule(static) reduction(max:diff0)
+                for (int i = 0; i < n; i++) {
+                    next[i] = jacobiRowUpdate(dot, A.rowPtr(i), cur, b[i], i, n);
+                    diff0 = max(diff0, fabs(next[i] - cur[i]));
+                }
+            } else if (slot == 1) {
+                #pragma omp for schedule(static) reduction(max:diff1)
+                for (int i = 0; i < n; i++) {
+                    next[i] = jacobiRowUpdate(dot, A.rowPtr(i), cur, b[i], i, n);
+                    diff1 = max(diff1, fabs(next[i] - cur[i]));
+                }
+            } else {
+                #pragma omp for schedule(static) reduction(max:diff2)
+                for (int i = 0; i < n; i++) {
+                    next[i] = jacobiRowUpdate(dot, A.rowPtr(i), cur, b[i], i, n);
+                    diff2 = max(diff2, fabs(next[i] - cur[i]));
+                }
+            }
+            
+            iter++;
+            swap(cur, next);
+            
+            double maxDiff = (slot == 0) ? diff0 : (slot == 1) ? diff1 : diff2;
+            if (maxDiff < tolerance) {
+                break;
+            }
+        }
+        
+        #pragma omp master
+        {
+            iterations = iter;
+            finalX = cur;
+        }
+    }
+    
+    // After an odd number of sweeps the result lives in the scratch buffer
+    if (finalX != x.data()) {
+        x.swap(x_new);
+    }
+    
+    return iterations;
+}
+
+// Parallel Jacobi on the legacy vector-of-rows layout.
+// Kept only as the "before" baseline for the storage comparison in main().
+int jacobiParallelNested(const vector<vector<double>>& A, const vector<double>& b,
+                         vector<double>& x, int n, double tolerance, int maxIterations,
+                         int numThreads) {
     vector<double> x_new(n, 0.0);
     int iterations = 0;
     
@@ -127,37 +465,1482 @@ int jacobiParallel(const vector<vector<double>>& A, const vector<double>& b,
 }
 
 // Function to verify solution by computing residual ||Ax - b||
-double computeResidual(const vector<vector<double>>& A, const vector<double>& b,
+// Rows are independent, so the O(n^2) pass runs in parallel with the SIMD
+// row kernel; the solvers that stop on the residual get it from the sweep
+double computeResidual(const DenseMatrix& A, const vector<double>& b,
                        const vector<double>& x, int n) {
+    RowDotFn dot = activeRowDotKernel().fn;
     double residual = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:residual)
+    for (int i = 0; i < n; i++) {
+        double r = dot(A.rowPtr(i), x.data(), n) - b[i];
+        residual += r * r;
+    }
+    return sqrt(residual);
+}
+
+// ||Ax - b|| / ||b||, the measure of StopCriterion::RelativeResidual
+double computeRelativeResidual(const DenseMatrix& A, const vector<double>& b,
+                               const vector<double>& x, int n) {
+    double normB = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:normB)
+    for (int i = 0; i < n; i++) {
+        normB += b[i] * b[i];
+    }
+    return computeResidual(A, b, x, n) / residualScale(sqrt(normB));
+}
+
+// Achieved GFLOP/s of a dense solve: each sweep does ~2n^2 flops (mul + add)
+double sweepGflops(int n, int iterations, double timeMs) {
+    if (timeMs <= 0.0) {
+        return 0.0;
+    }
+    return 2.0 * n * (double)n * iterations / (timeMs * 1.0e6);
+}
+
+// Sparse stencil systems: CSR vs SELL-C-sigma vs ELL at every thread count
+void runSparseBenchmarks(const vector<int>& threadCounts, int maxThreads,
+                         double tolerance, int maxIterations) {
+    struct Grid { int nx, ny, nz; const char* label; };
+    vector<Grid> grids = {{1024, 1024, 1, "2D 5-point"}, {100, 100, 100, "3D 7-point"}};
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Sparse stencil systems" << endl;
+    cout << "=====================================================" << endl;
+    
+    for (const Grid& g : grids) {
+        CsrMatrix csr;
+        vector<double> b;
+        initializeStencilSystem(csr, b, g.nx, g.ny, g.nz);
+        int n = csr.n;
+        SellMatrix sell = buildSell(csr, 8, 256);
+        SellMatrix ell = buildEll(csr);
+        CsrSplit csrSplit = splitCsr(csr);
+        
+        cout << "\n" << g.label << " grid " << g.nx << "x" << g.ny << "x" << g.nz
+             << ": " << n << " unknowns, " << csr.nnz() << " nonzeros" << endl;
+        cout << "-----------------------------------------------------------------------" << endl;
+        cout << setw(14) << "Format" << setw(10) << "Threads" << setw(12) << "Iterations"
+             << setw(13) << "Time (ms)" << setw(11) << "GFLOP/s" << setw(15) << "Residual" << endl;
+        cout << "-----------------------------------------------------------------------" << endl;
+        
+        for (int numThreads : threadCounts) {
+            if (numThreads > maxThreads) {
+                continue;
+            }
+            for (int format = 0; format < 4; format++) {
+                vector<double> x(n, 0.0);
+                double start = omp_get_wtime();
+                int iterations = 0;
+                const char* name = "CSR";
+                if (format == 0) {
+                    iterations = jacobiParallel(csr, b, x, n, tolerance, maxIterations, numThreads);
+                } else if (format == 1) {
+                    name = "SELL-8-256";
+                    iterations = jacobiParallel(sell, b, x, n, tolerance, maxIterations, numThreads);
+                } else if (format == 2) {
+                    name = "ELL";
+                    iterations = jacobiParallel(ell, b, x, n, tolerance, maxIterations, numThreads);
+                } else {
+                    name = "CSR D^-1+R";
+                    iterations = jacobiParallel(csrSplit, b, x, n, tolerance, maxIterations,
+                                                numThreads);
+                }
+                double timeMs = (omp_get_wtime() - start) * 1000.0;
+                double gflops = 2.0 * csr.nnz() * iterations / (timeMs * 1.0e6);
+                double residual = computeResidual(csr, b, x, n);
+                
+                cout << setw(14) << name << setw(10) << numThreads << setw(12) << iterations
+                     << setw(13) << setprecision(3) << timeMs << setw(11) << gflops
+                     << setw(15) << scientific << residual << fixed << setprecision(6) << endl;
+            }
+        }
+    }
+}
+
+// CSR system with hub rows (row lengths from 1000 down to 5, the long
+// ones first): schedule(static) over rows against nnz-balanced row blocks,
+// without and with work stealing
+void runSkewedSparseBenchmarks(const vector<int>& threadCounts, int maxThreads,
+                               double tolerance, int maxIterations) {
+    const int n = 100000;
+    CsrMatrix csr;
+    vector<double> b;
+    initializeSkewedSystem(csr, b, n, 1000);
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Skewed sparse rows (" << n << " unknowns, " << csr.nnz() << " nonzeros, rows of "
+         << csr.rowLength(n - 1) << "-" << csr.rowLength(0) << ")" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(10) << "Threads" << setw(16) << "Schedule" << setw(12) << "Iterations"
+         << setw(13) << "Time (ms)" << setw(11) << "GFLOP/s" << setw(11) << "Imbalance"
+         << setw(14) << "Steals/sweep" << setw(14) << "Residual" << endl;
+    for (int numThreads : threadCounts) {
+        if (numThreads > maxThreads) {
+            continue;
+        }
+        // Largest per-thread nonzero count over the mean, for even row counts
+        long long maxStatic = 0;
+        for (int t = 0; t < numThreads; t++) {
+            int lo = (int)((long long)n * t / numThreads);
+            int hi = (int)((long long)n * (t + 1) / numThreads);
+            maxStatic = max(maxStatic, (long long)csr.rowPtr[hi] - csr.rowPtr[lo]);
+        }
+        double staticImbalance = (double)maxStatic * numThreads / csr.nnz();
+        
+        for (int mode = 0; mode < 3; mode++) {
+            vector<double> x(n, 0.0);
+            const char* name = mode == 0 ? "static rows" : mode == 1 ? "nnz blocks" : "nnz + steal";
+            WorkStealingScheduler scheduler(csr, numThreads, 8, mode == 2);
+            double imbalance = staticImbalance;
+            if (mode > 0) {
+                long long maxOwned = 0;
+                for (int t = 0; t < numThreads; t++) {
+                    RowBlock rows = scheduler.ownedRows(t);
+                    maxOwned = max(maxOwned,
+                                   (long long)csr.rowPtr[rows.end] - csr.rowPtr[rows.begin]);
+                }
+                imbalance = (double)maxOwned * numThreads / csr.nnz();
+            }
+            double start = omp_get_wtime();
+            int iterations = mode == 0
+                ? jacobiParallel(csr, b, x, n, tolerance, maxIterations, numThreads)
+                : jacobiParallel(csr, b, x, n, tolerance, maxIterations, scheduler);
+            double timeMs = (omp_get_wtime() - start) * 1000.0;
+            double gflops = 2.0 * csr.nnz() * iterations / (timeMs * 1.0e6);
+            cout << setw(10) << numThreads << setw(16) << name << setw(12) << iterations
+                 << setw(13) << setprecision(3) << timeMs << setw(11) << gflops << setw(10)
+                 << setprecision(2) << imbalance << "x" << setw(14) << setprecision(1)
+                 << (double)scheduler.stats().steals / iterations << setw(14) << scientific
+                 << setprecision(3) << computeResidual(csr, b, x, n) << fixed << setprecision(6)
+                 << endl;
+        }
+    }
+}
+
+// Matrix-free stencil Jacobi: naive, spatially and temporally blocked sweeps.
+// Bytes/flop (model) is the compulsory traffic of stencilBytesPerFlop; where
+// perf_event is available the LLC-miss traffic of every run is measured as
+// well, with the dense path measured the same way as the reference.
+void runStencilBenchmarks(const vector<int>& threadCounts, int maxThreads,
+                          double tolerance, int maxIterations) {
+    // Shifted Poisson (diag = 2*dims + 0.5) so plain Jacobi converges in a few hundred sweeps
+    vector<StencilProblem> problems = {{2048, 2048, 1, 0.5}, {160, 160, 160, 0.5}};
+    struct Variant { const char* name; StencilBlocking blocking; };
+    vector<Variant> variants = {
+        {"naive", {1, 1, 1}},
+        {"spatial", {32, 8, 1}},
+        {"temporal T=4", {64, 16, 4}},
+        {"temporal T=8", {128, 32, 8}},
+    };
+    // Dense sweep streams 8 bytes of A per multiply-add pair
+    const double denseBytesPerFlop = 8.0 / 2.0;
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Matrix-free stencil systems" << endl;
+    cout << "=====================================================" << endl;
+    cout << "Dense jacobiParallel reference: " << setprecision(2) << denseBytesPerFlop
+         << " bytes/flop (model)";
+    bool measured = HardwareCounters(1).available();
+    if (measured) {
+        // A matrix well beyond the LLC, so the sweeps stream A from memory
+        const int n = 4000, sweeps = 10;
+        int numThreads = min(maxThreads, threadCounts.back());
+        DenseMatrix A(n, n, numThreads);
+        vector<double> b(n), x(n, 0.0);
+        initializeSystem(A, b, n);
+        HardwareCounters counters(numThreads);
+        counters.start();
+        jacobiParallel(A, b, x, n, 0.0, sweeps, numThreads);
+        CounterValues values = counters.stop();
+        cout << ", " << values.bytesFromMemory() / (2.0 * n * (double)n * sweeps)
+             << " measured (LLC misses, n = " << n << ")";
+    }
+    cout << setprecision(6) << endl;
+    if (!measured) {
+        cout << "Hardware counters unavailable, traffic columns are the model only" << endl;
+    }
+    
+    for (const StencilProblem& P : problems) {
+        vector<double> b;
+        initializeStencilRhs(P, b);
+        int n = P.n();
+        
+        cout << "\n" << (P.is3D() ? "3D 7-point" : "2D 5-point") << " grid " << P.nx << "x"
+             << P.ny << "x" << P.nz << ": " << n << " unknowns" << endl;
+        string rule(measured ? 111 : 87, '-');
+        cout << rule << endl;
+        cout << setw(14) << "Variant" << setw(10) << "Threads" << setw(12) << "Iterations"
+             << setw(13) << "Time (ms)" << setw(11) << "GFLOP/s" << setw(14) << "GB/s (model)"
+             << setw(16) << "B/flop (model)";
+        if (measured) {
+            cout << setw(12) << "GB/s (LLC)" << setw(14) << "B/flop (LLC)";
+        }
+        cout << endl << rule << endl;
+        
+        for (int numThreads : threadCounts) {
+            if (numThreads > maxThreads) {
+                continue;
+            }
+            HardwareCounters counters(numThreads);
+            for (const Variant& v : variants) {
+                vector<double> x(n, 0.0);
+                counters.start();
+                double start = omp_get_wtime();
+                int iterations = jacobiStencil(P, b, x, n, tolerance, maxIterations,
+                                               numThreads, v.blocking);
+                double timeMs = (omp_get_wtime() - start) * 1000.0;
+                CounterValues values = counters.stop();
+                double flops = P.flopsPerPoint() * n * (double)iterations;
+                double gflops = flops / (timeMs * 1.0e6);
+                double bytesPerFlop = stencilBytesPerFlop(P, v.blocking.timeSteps);
+                
+                cout << setw(14) << v.name << setw(10) << numThreads << setw(12) << iterations
+                     << setw(13) << setprecision(3) << timeMs << setw(11) << gflops
+                     << setw(14) << gflops * bytesPerFlop << setw(16) << bytesPerFlop;
+                if (measured) {
+                    cout << setw(12) << values.bytesFromMemory() / (timeMs * 1.0e6)
+                         << setw(14) << values.bytesFromMemory() / flops;
+                }
+                cout << setprecision(6) << endl;
+            }
+            vector<double> check(n, 0.0);
+            jacobiStencil(P, b, check, n, tolerance, maxIterations, numThreads, variants.back().blocking);
+            cout << "  residual (temporal T=8): " << scientific << setprecision(3)
+                 << computeResidual(P, b, check, n) << fixed << setprecision(6) << endl;
+        }
+    }
+}
+
+// Dense system on first-touched storage: zeroed by numThreads threads with
+// the solver's static row partition, then filled with the usual values
+DenseMatrix firstTouchSystem(int n, int numThreads, vector<double>& b) {
+    DenseMatrix A(n, n, numThreads);
+    initializeSystem(A, b, n);
+    return A;
+}
+
+// Scaling within and across sockets: compact fills one socket before the
+// next, scatter spreads threads over all sockets. Each run pins the threads
+// and compares A initialised serially (all pages on the first node) with A
+// first-touched by the same pinned threads.
+void runNumaBenchmarks(const CpuTopology& topo, const vector<int>& threadCounts, int maxThreads,
+                       int n, double tolerance, int maxIterations, ThreadPlacement restore) {
+    vector<int> counts;
+    for (int t : threadCounts) {
+        if (t <= maxThreads) {
+            counts.push_back(t);
+        }
+    }
+    // Add one full socket and all cores if the regular counts miss them
+    int perSocket = topo.numCores() / topo.numSockets();
+    for (int t : {perSocket, topo.numCores()}) {
+        if (t <= maxThreads && find(counts.begin(), counts.end(), t) == counts.end()) {
+            counts.push_back(t);
+        }
+    }
+    sort(counts.begin(), counts.end());
+    
+    cout << "\n=====================================================" << endl;
+    cout << "NUMA placement (" << n << " x " << n << ")" << endl;
+    cout << "=====================================================" << endl;
+    
+    // Zeroed by one thread, so every page sits on that thread's node
+    vector<double> b(n);
+    DenseMatrix serialA(n, n);
+    initializeSystem(serialA, b, n);
+    
+    cout << setw(10) << "Threads" << setw(11) << "Placement" << setw(9) << "Sockets"
+         << setw(17) << "Serial init(ms)" << setw(17) << "First-touch(ms)"
+         << setw(12) << "GFLOP/s" << setw(14) << "GFLOP/s/sock" << endl;
+    for (ThreadPlacement placement : {ThreadPlacement::Compact, ThreadPlacement::Scatter}) {
+        for (int numThreads : counts) {
+            if (!topo.pinThreads(numThreads, placement)) {
+                cout << "  thread pinning not supported on this platform" << endl;
+                return;
+            }
+            int sockets = topo.socketsSpanned(placement, numThreads);
+            
+            vector<double> x(n, 0.0);
+            double start = omp_get_wtime();
+            jacobiParallel(serialA, b, x, n, tolerance, maxIterations, numThreads);
+            double serialMs = (omp_get_wtime() - start) * 1000.0;
+            
+            vector<double> bLocal(n);
+            DenseMatrix localA = firstTouchSystem(n, numThreads, bLocal);
+            fill(x.begin(), x.end(), 0.0);
+            start = omp_get_wtime();
+            int iterations = jacobiParallel(localA, bLocal, x, n, tolerance, maxIterations,
+                                            numThreads);
+            double localMs = (omp_get_wtime() - start) * 1000.0;
+            double gflops = sweepGflops(n, iterations, localMs);
+            
+            cout << setw(10) << numThreads << setw(11) << placementName(placement)
+                 << setw(9) << sockets << setw(17) << setprecision(3) << serialMs
+                 << setw(17) << localMs << setw(12) << gflops << setw(14) << gflops / sockets
+                 << setprecision(6) << endl;
+        }
+    }
+    topo.pinThreads(maxThreads, restore);
+}
+
+// Cache blocking at sizes where x (8n bytes) outgrows L1 and A streams from
+// memory: plain jacobiParallel vs the tiled sweep with its tuned tiles.
+// A fixed number of sweeps per size (tolerance 0) keeps the runs short;
+// sizes whose matrix would need more than half of the memory are skipped.
+void runTiledBenchmarks(int numThreads, int maxN) {
+    size_t memory = physicalMemoryBytes();
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Cache-blocked dense sweep (" << numThreads << " threads)" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(8) << "n" << setw(8) << "Sweeps" << setw(12) << "Row block" << setw(12)
+         << "Col block" << setw(12) << "Tune (ms)" << setw(15) << "Naive GFLOP/s"
+         << setw(15) << "Tiled GFLOP/s" << setw(8) << "Gain" << endl;
+    for (int n : {1000, 2000, 4000, 8000, 16000}) {
+        double matrixBytes = 8.0 * n * n;
+        if (n > maxN || (memory > 0 && matrixBytes > 0.5 * memory)) {
+            cout << setw(8) << n << "  skipped (" << setprecision(1) << matrixBytes / 1.0e9
+                 << " GB matrix)" << setprecision(6) << endl;
+            continue;
+        }
+        DenseMatrix A(n, n, numThreads);
+        vector<double> b(n);
+        initializeSystem(A, b, n);
+        int sweeps = max(5, (int)(4.0e8 / ((double)n * n)));
+        
+        double start = omp_get_wtime();
+        TileConfig tiles = tuneTiles(A, b, n, numThreads);
+        double tuneMs = (omp_get_wtime() - start) * 1000.0;
+        
+        vector<double> x(n, 0.0);
+        start = omp_get_wtime();
+        jacobiParallel(A, b, x, n, 0.0, sweeps, numThreads);
+        double naiveMs = (omp_get_wtime() - start) * 1000.0;
+        
+        fill(x.begin(), x.end(), 0.0);
+        start = omp_get_wtime();
+        jacobiParallelTiled(A, b, x, n, 0.0, sweeps, numThreads, tiles);
+        double tiledMs = (omp_get_wtime() - start) * 1000.0;
+        
+        cout << setw(8) << n << setw(8) << sweeps << setw(12) << tiles.rowBlock << setw(12)
+             << (tiles.colBlock > 0 ? to_string(tiles.colBlock) : string("row"))
+             << setw(12) << setprecision(1) << tuneMs << setw(15) << setprecision(3)
+             << sweepGflops(n, sweeps, naiveMs) << setw(15) << sweepGflops(n, sweeps, tiledMs)
+             << setw(7) << setprecision(2) << naiveMs / tiledMs << "x" << setprecision(6) << endl;
+    }
+}
+
+// Scaling model fitted per size to the measured parallel times (t1Ms[s] is
+// the 1-thread time, or the sequential one if 1 thread was not run), with
+// the thread count the model predicts to be fastest up to maxThreads
+vector<ScalingFit> printScalingModel(const vector<int>& sizes,
+                                     const vector<vector<ScalingSample>>& samples,
+                                     const vector<double>& t1Ms, int maxThreads) {
+    cout << "   T(P) = max(T1 (s + (1-s)/P), T1/Smax) + c (P-1)" << endl;
+    cout << setw(10) << "Size" << setw(12) << "T1 (ms)" << setw(8) << "s" << setw(8) << "Smax"
+         << setw(12) << "c (ms/thr)" << setw(10) << "Fit err" << setw(12) << "Best meas."
+         << setw(12) << "Best pred." << setw(12) << "Pred. S" << endl;
+    vector<ScalingFit> fits;
+    for (size_t s = 0; s < sizes.size(); s++) {
+        ScalingFit fit = fitScaling(samples[s], t1Ms[s]);
+        fits.push_back(fit);
+        int measuredBest = 0;
+        double measuredMs = 0.0;
+        for (const ScalingSample& smp : samples[s]) {
+            if (measuredBest == 0 || smp.timeMs < measuredMs) {
+                measuredBest = smp.threads;
+                measuredMs = smp.timeMs;
+            }
+        }
+        cout << setw(10) << sizes[s] << setw(12) << setprecision(3) << t1Ms[s];
+        if (!fit.valid) {
+            cout << "   needs runs with at least two thread counts" << setprecision(6) << endl;
+            continue;
+        }
+        int best = fit.bestThreads(maxThreads);
+        cout << setw(8) << setprecision(3) << fit.serialFraction << setw(8) << setprecision(2);
+        if (isinf(fit.maxSpeedup)) {
+            cout << "-";
+        } else {
+            cout << fit.maxSpeedup;
+        }
+        cout << setw(12) << setprecision(3) << fit.overheadMs << setw(9) << setprecision(1)
+             << fit.rmsError * 100.0 << "%" << setw(12) << measuredBest << setw(12) << best
+             << setw(11) << setprecision(2) << fit.predictSpeedup(best) << "x" << setprecision(6)
+             << endl;
+    }
+    return fits;
+}
+
+// Roofline of the machine and where the measured dense sweeps sit under it
+void printRoofline(const RooflineMachine& machine,
+                   const vector<pair<string, double>>& variantGflops) {
+    double attainable = machine.attainableGflops(kDenseSweepIntensity);
+    cout << setprecision(2);
+    cout << "   Peak FMA: " << machine.peakGflops << " GFLOP/s, STREAM triad: "
+         << machine.streamGBs << " GB/s, ridge at " << machine.ridgeIntensity() << " flop/byte"
+         << endl;
+    cout << "   Dense sweep: " << kDenseSweepIntensity << " flop/byte -> "
+         << (attainable < machine.peakGflops ? "memory" : "compute") << "-bound, attainable "
+         << attainable << " GFLOP/s" << endl;
+    bool aboveRoof = false;
+    for (const auto& v : variantGflops) {
+        cout << "   " << setw(18) << left << v.first << right << setw(10) << v.second
+             << " GFLOP/s  (" << setprecision(1) << 100.0 * v.second / attainable
+             << "% of roofline)" << setprecision(2) << endl;
+        aboveRoof = aboveRoof || v.second > attainable;
+    }
+    if (aboveRoof) {
+        cout << "   (above 100%: the matrix is cache-resident, so the STREAM roof does not bind)"
+             << endl;
+    }
+    cout << setprecision(6);
+}
+
+// JSON members for the harness report: the fits and the machine roofline
+string scalingJson(const vector<int>& sizes, const vector<ScalingFit>& fits, int maxThreads) {
+    ostringstream out;
+    out.precision(9);
+    out << "[";
+    for (size_t s = 0; s < sizes.size(); s++) {
+        const ScalingFit& f = fits[s];
+        out << (s ? ",\n    " : "\n    ") << "{\"n\": " << sizes[s] << ", \"valid\": "
+            << (f.valid ? "true" : "false") << ", \"t1_ms\": " << f.t1Ms
+            << ", \"serial_fraction\": " << f.serialFraction << ", \"max_speedup\": ";
+        if (isinf(f.maxSpeedup)) {
+            out << "null";
+        } else {
+            out << f.maxSpeedup;
+        }
+        out << ", \"overhead_ms\": " << f.overheadMs << ", \"rms_error\": " << f.rmsError
+            << ", \"best_threads\": " << (f.valid ? f.bestThreads(maxThreads) : 0)
+            << ", \"max_threads\": " << maxThreads << "}";
+    }
+    out << "\n  ]";
+    return out.str();
+}
+
+string rooflineJson(const RooflineMachine& machine) {
+    ostringstream out;
+    out.precision(9);
+    out << "{\"peak_gflops\": " << machine.peakGflops << ", \"stream_gbs\": "
+        << machine.streamGBs << ", \"dense_sweep_intensity\": " << kDenseSweepIntensity << "}";
+    return out.str();
+}
+
+// Harness mode: sequential, parallel (fork/join and persistent region) and
+// device solves of every size, each with warmup and repeated trials; the
+// records carry the timing statistics for the JSON/CSV report
+void runHarnessBenchmarks(BenchmarkHarness& harness, const vector<int>& sizes,
+                          const vector<int>& threadCounts, int maxThreads, double tolerance,
+                          int maxIterations, bool device) {
+    cout << "\n=====================================================" << endl;
+    cout << "Benchmark harness (" << harness.warmup() << " warmup, " << harness.trials()
+         << " trials per configuration)" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(8) << "n" << setw(9) << "Threads" << setw(13) << "Variant" << setw(12)
+         << "Min (ms)" << setw(13) << "Median (ms)" << setw(11) << "P95 (ms)" << setw(11)
+         << "Stddev" << setw(10) << "GFLOP/s" << endl;
+    
+    for (int n : sizes) {
+        DenseMatrix A(n, n, min(maxThreads, threadCounts.back()));
+        vector<double> b(n), x(n);
+        initializeSystem(A, b, n);
+        
+        auto record = [&](int threads, const char* variant, const function<int()>& solve) {
+            BenchmarkRecord r;
+            r.n = n;
+            r.threads = threads;
+            r.variant = variant;
+            r.timeMs = harness.measure(solve, &r.iterations);
+            r.gflops = sweepGflops(n, r.iterations, r.timeMs.median);
+            r.residual = computeResidual(A, b, x, n);
+            harness.add(r);
+            cout << setw(8) << n << setw(9) << threads << setw(13) << variant << setw(12)
+                 << setprecision(3) << r.timeMs.min << setw(13) << r.timeMs.median << setw(11)
+                 << r.timeMs.p95 << setw(11) << r.timeMs.stddev << setw(10) << r.gflops
+                 << setprecision(6) << endl;
+        };
+        
+        record(1, "sequential", [&]() {
+            fill(x.begin(), x.end(), 0.0);
+            return jacobiSequential(A, b, x, n, tolerance, maxIterations);
+        });
+        for (int numThreads : threadCounts) {
+            if (numThreads > maxThreads) {
+                continue;
+            }
+            record(numThreads, "parallel", [&]() {
+                fill(x.begin(), x.end(), 0.0);
+                return jacobiParallel(A, b, x, n, tolerance, maxIterations, numThreads);
+            });
+            record(numThreads, "persistent", [&]() {
+                fill(x.begin(), x.end(), 0.0);
+                return jacobiParallelPersistent(A, b, x, n, tolerance, maxIterations, numThreads);
+            });
+        }
+        if (device) {
+            record(1, "device", [&]() {
+                fill(x.begin(), x.end(), 0.0);
+                return jacobiDevice(A, b, x, n, tolerance, maxIterations);
+            });
+        }
+    }
+    
+    // Models of the median times go into the report next to the records
+    vector<vector<ScalingSample>> samples(sizes.size());
+    vector<double> t1Ms(sizes.size(), 0.0), sequentialMs(sizes.size(), 0.0);
+    vector<pair<string, double>> bestGflops;
+    for (const BenchmarkRecord& r : harness.records()) {
+        size_t s = find(sizes.begin(), sizes.end(), r.n) - sizes.begin();
+        if (r.variant == "parallel") {
+            samples[s].push_back({r.threads, r.timeMs.median});
+            if (r.threads == 1) {
+                t1Ms[s] = r.timeMs.median;
+            }
+        } else if (r.variant == "sequential") {
+            sequentialMs[s] = r.timeMs.median;
+        }
+        auto it = find_if(bestGflops.begin(), bestGflops.end(),
+                          [&r](const pair<string, double>& v) { return v.first == r.variant; });
+        if (it == bestGflops.end()) {
+            bestGflops.push_back({r.variant, r.gflops});
+        } else {
+            it->second = max(it->second, r.gflops);
+        }
+    }
+    for (size_t s = 0; s < sizes.size(); s++) {
+        if (t1Ms[s] == 0.0) {
+            t1Ms[s] = sequentialMs[s];
+        }
+    }
+    
+    cout << "\nScaling model (median times):" << endl;
+    vector<ScalingFit> fits = printScalingModel(sizes, samples, t1Ms, maxThreads);
+    RooflineMachine machine = measureRoofline(maxThreads);
+    cout << "\nRoofline (best GFLOP/s per variant):" << endl;
+    printRoofline(machine, bestGflops);
+    harness.addSection("scaling", scalingJson(sizes, fits, maxThreads));
+    harness.addSection("roofline", rooflineJson(machine));
+}
+
+// Autotuning mode: per size, start from the cached configuration for this
+// machine or tune one with short trial sweeps (and cache it), then solve
+// with it and compare against the default jacobiParallel setup
+bool runAutotuneBenchmarks(const vector<int>& sizes, int maxThreads, double tolerance,
+                           int maxIterations, const string& cachePath, bool allowReducedPrecision) {
+    TuningCache cache;
+    string error;
+    if (!cache.load(cachePath, error)) {
+        cerr << "Error: " << error << endl;
+        return false;
+    }
+    string machine = machineSignature();
+    AutotuneOptions tuneOptions;
+    tuneOptions.maxThreads = maxThreads;
+    tuneOptions.allowReducedPrecision = allowReducedPrecision;
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Autotuned sweep (" << machine << ", cache " << cachePath << ")" << endl;
+    cout << "=====================================================" << endl;
+    
+    for (int n : sizes) {
+        DenseMatrix A(n, n, maxThreads);
+        vector<double> b(n);
+        initializeSystem(A, b, n);
+        TunableSystem system(A);
+        
+        SweepConfig config;
+        string source = "cached";
+        double tuneMs = 0.0;
+        int trials = 0;
+        bool cached = cache.lookup(machine, n, config);
+        if (cached && !configAllowed(config, tuneOptions)) {
+            cout << "\nn = " << n << ": cached configuration (" << describeConfig(config)
+                 << ") not allowed in this run, tuning again" << endl;
+            cached = false;
+        }
+        if (!cached) {
+            double start = omp_get_wtime();
+            config = autotune(system, b, tuneOptions, &trials);
+            tuneMs = (omp_get_wtime() - start) * 1000.0;
+            cache.store(machine, n, config);
+            source = "tuned";
+        }
+        
+        vector<double> x(n, 0.0);
+        double start = omp_get_wtime();
+        int defaultIters = jacobiParallel(A, b, x, n, tolerance, maxIterations, maxThreads);
+        double defaultMs = (omp_get_wtime() - start) * 1000.0;
+        
+        fill(x.begin(), x.end(), 0.0);
+        start = omp_get_wtime();
+        int tunedIters = system.solve(b, x, tolerance, maxIterations, config);
+        double tunedMs = (omp_get_wtime() - start) * 1000.0;
+        
+        cout << "\nn = " << n << ": " << source << " configuration: " << describeConfig(config)
+             << endl;
+        if (source == "tuned") {
+            cout << "  Tuning: " << trials << " trials, " << setprecision(1) << tuneMs << " ms"
+                 << setprecision(6) << endl;
+        }
+        cout << setprecision(3);
+        cout << "  Default (" << maxThreads << " threads, static): " << defaultMs << " ms, "
+             << defaultIters << " iterations" << endl;
+        cout << "  Tuned:  " << tunedMs << " ms, " << tunedIters << " iterations, "
+             << setprecision(2) << defaultMs / tunedMs << "x" << endl;
+        cout << "  Residual: " << scientific << computeResidual(A, b, x, n) << fixed
+             << setprecision(6) << endl;
+    }
+    
+    if (!cache.save(cachePath, error)) {
+        cerr << "Error: " << error << endl;
+        return false;
+    }
+    return true;
+}
+
+// Time to tolerance of the bulk-synchronous jacobiParallel against the
+// barrier-free asynchronous sweep; async sweep counts are per thread
+void runAsyncBenchmarks(int n, const vector<int>& threadCounts, int maxThreads,
+                        double tolerance, int maxIterations) {
+    DenseMatrix A(n, n, min(maxThreads, threadCounts.back()));
+    vector<double> b(n);
+    initializeSystem(A, b, n);
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Asynchronous Jacobi (" << n << " x " << n << ")" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(8) << "Threads" << setw(12) << "Sync iters" << setw(12) << "Sync (ms)"
+         << setw(16) << "Async sweeps" << setw(12) << "Async (ms)" << setw(8) << "Gain"
+         << setw(13) << "Sync resid" << setw(13) << "Async resid" << endl;
+    for (int numThreads : threadCounts) {
+        if (numThreads > maxThreads) {
+            continue;
+        }
+        vector<double> xSync(n, 0.0), xAsync(n, 0.0);
+        double start = omp_get_wtime();
+        int iterations = jacobiParallel(A, b, xSync, n, tolerance, maxIterations, numThreads);
+        double syncMs = (omp_get_wtime() - start) * 1000.0;
+        
+        AsyncStats st;
+        start = omp_get_wtime();
+        jacobiParallelAsync(A, b, xAsync, n, tolerance, maxIterations, numThreads, &st);
+        double asyncMs = (omp_get_wtime() - start) * 1000.0;
+        
+        string range = to_string(st.minSweeps) + "-" + to_string(st.maxSweeps);
+        cout << setw(8) << numThreads << setw(12) << iterations << setw(12) << setprecision(3)
+             << syncMs << setw(16) << range << setw(12) << asyncMs << setw(7) << setprecision(2)
+             << syncMs / asyncMs << "x" << setw(13) << scientific << setprecision(3)
+             << computeResidual(A, b, xSync, n) << setw(13) << computeResidual(A, b, xAsync, n)
+             << fixed << setprecision(6) << endl;
+    }
+}
+
+// Many solves of one small system: jacobiSequential against the small-system
+// path (compile-time kernel where n has one, "-" marks the generic
+// fallback) and its generic sweep; "Max |dx|" compares the two solutions
+void runSmallSystemBenchmarks(double tolerance, int maxIterations) {
+    const SmallJacobiKernels& kernels = activeSmallJacobiKernels();
+    cout << "\n=====================================================" << endl;
+    cout << "Small systems (sequential, " << kernels.name << ", time per solve)" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(6) << "n" << setw(8) << "Fixed" << setw(8) << "Iters" << setw(16)
+         << "Sequential(us)" << setw(13) << "Generic(us)" << setw(11) << "Small(us)"
+         << setw(9) << "Gain" << setw(12) << "Max |dx|" << endl;
+    for (int n : {4, 8, 12, 16, 24, 32, 48, 64, 50}) {
+        DenseMatrix A(n, n);
+        vector<double> b(n);
+        initializeSystem(A, b, n);
+        const int solves = max(200, (int)(1.0e6 / ((double)n * n)));
+        
+        // Best of three batches of `solves` solves from x = 0
+        auto timeSolves = [&](auto&& solve, vector<double>& x, int& iterations) {
+            double best = 0.0;
+            for (int r = 0; r < 3; r++) {
+                double start = omp_get_wtime();
+                for (int s = 0; s < solves; s++) {
+                    fill(x.begin(), x.end(), 0.0);
+                    iterations = solve(x);
+                }
+                double us = (omp_get_wtime() - start) * 1.0e6 / solves;
+                best = r == 0 ? us : min(best, us);
+            }
+            return best;
+        };
+        vector<double> xSeq(n), xGeneric(n), xSmall(n);
+        int itSeq = 0, itGeneric = 0, itSmall = 0;
+        double seqUs = timeSolves([&](vector<double>& x) {
+            return jacobiSequential(A, b, x, n, tolerance, maxIterations);
+        }, xSeq, itSeq);
+        double genericUs = timeSolves([&](vector<double>& x) {
+            return jacobiSmallGeneric(A, b, x, n, tolerance, maxIterations, kernels.dot);
+        }, xGeneric, itGeneric);
+        double smallUs = timeSolves([&](vector<double>& x) {
+            return jacobiSmall(A, b, x, n, tolerance, maxIterations);
+        }, xSmall, itSmall);
+        double maxDx = 0.0;
+        for (int i = 0; i < n; i++) {
+            maxDx = max(maxDx, fabs(xSmall[i] - xGeneric[i]));
+        }
+        
+        cout << setw(6) << n << setw(8) << (findSmallJacobi(n) ? "yes" : "-") << setw(8)
+             << itSmall << setw(16) << setprecision(3) << seqUs << setw(13) << genericUs
+             << setw(11) << smallUs << setw(8) << setprecision(2) << seqUs / smallUs << "x"
+             << setw(12) << scientific << setprecision(1) << maxDx << fixed << setprecision(6)
+             << endl;
+        if (itSeq != itSmall || itGeneric != itSmall) {
+            cout << "  (jacobiSequential " << itSeq << ", generic " << itGeneric << " iterations)"
+                 << endl;
+        }
+    }
+}
+
+// Thousands of independent small systems: one jacobiParallel call per
+// system, one jacobiSmall per system spread over the threads, and the
+// interleaved SystemBatch engine, in systems solved per second
+void runSystemBatchBenchmarks(int numThreads, double tolerance, int maxIterations) {
+    const int count = 4096;
+    cout << "\n=====================================================" << endl;
+    cout << "Batched independent systems (" << count << " systems, " << numThreads
+         << " threads, " << activePackSweep().name << " packs of " << kBatchLanes << ")" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(5) << "n" << setw(18) << "Per-call (sys/s)" << setw(20) << "Per-thread (sys/s)"
+         << setw(15) << "Batch (sys/s)" << setw(8) << "Gain" << setw(9) << "Lanes"
+         << setw(8) << "Iters" << setw(13) << "Max resid" << endl;
+    for (int n : {8, 16, 32, 64}) {
+        vector<DenseMatrix> A(count);
+        vector<vector<double>> b(count, vector<double>(n));
+        SystemBatch batch(n, count);
+        for (int s = 0; s < count; s++) {
+            A[s] = DenseMatrix(n, n);
+            initializeSystem(A[s], b[s], n, kSystemSeed + s);
+            batch.setSystem(s, A[s], b[s]);
+        }
+        vector<vector<double>> x(count, vector<double>(n));
+        
+        double start = omp_get_wtime();
+        for (int s = 0; s < count; s++) {
+            fill(x[s].begin(), x[s].end(), 0.0);
+            jacobiParallel(A[s], b[s], x[s], n, tolerance, maxIterations, numThreads);
+        }
+        double perCallS = omp_get_wtime() - start;
+        
+        start = omp_get_wtime();
+        #pragma omp parallel for schedule(dynamic, 16) num_threads(numThreads)
+        for (int s = 0; s < count; s++) {
+            fill(x[s].begin(), x[s].end(), 0.0);
+            jacobiSmall(A[s], b[s], x[s], n, tolerance, maxIterations);
+        }
+        double perThreadS = omp_get_wtime() - start;
+        
+        start = omp_get_wtime();
+        BatchSolveStats st = solveBatch(batch, tolerance, maxIterations, numThreads);
+        double batchS = omp_get_wtime() - start;
+        
+        double maxResidual = 0.0;
+        vector<double> xs;
+        for (int s = 0; s < count; s++) {
+            batch.solution(s, xs);
+            maxResidual = max(maxResidual, computeResidual(A[s], b[s], xs, n));
+        }
+        cout << setw(5) << n << setw(18) << setprecision(0) << count / perCallS << setw(20)
+             << count / perThreadS << setw(15) << count / batchS << setw(7) << setprecision(2)
+             << perThreadS / batchS << "x" << setw(8) << setprecision(0)
+             << 100.0 * st.utilisation() << "%" << setw(8) << st.maxIterations << setw(13)
+             << scientific << setprecision(3) << maxResidual << fixed << setprecision(6) << endl;
+    }
+    cout << "Gain: batch vs per-thread; Lanes: SIMD lanes doing useful work" << endl;
+}
+
+// Allocation counters of the arena plus the THP-backed bytes of the process
+void printMemoryStats(const MemoryStats& s) {
+    const double mb = 1024.0 * 1024.0;
+    cout << "   Allocations: " << s.allocations << " (" << s.mappedAllocations
+         << " huge-page sized), released: " << s.releases << endl;
+    cout << setprecision(1);
+    cout << "   Allocated: " << s.totalBytes / mb << " MB total, peak " << s.peakBytes / mb
+         << " MB live, " << s.liveBytes / mb << " MB live now" << endl;
+    cout << "   Huge pages (" << hugePagesName(memoryArena().policy())
+         << "): " << s.explicitHugeBytes / mb << " MB explicit, " << transparentHugeBytes() / mb
+         << " MB transparent, " << s.fallbacks << " explicit fallbacks" << endl;
+    cout << setprecision(6);
+}
+
+string memoryJson(const MemoryStats& s) {
+    ostringstream out;
+    out << "{\"huge_pages\": \"" << hugePagesName(memoryArena().policy())
+        << "\", \"allocations\": " << s.allocations << ", \"huge_page_sized\": "
+        << s.mappedAllocations << ", \"releases\": " << s.releases << ", \"total_bytes\": "
+        << s.totalBytes << ", \"peak_bytes\": " << s.peakBytes << ", \"explicit_huge_bytes\": "
+        << s.explicitHugeBytes << ", \"transparent_huge_bytes\": " << transparentHugeBytes()
+        << ", \"fallbacks\": " << s.fallbacks << "}";
+    return out.str();
+}
+
+// The same fixed number of sweeps over an n x n matrix allocated under each
+// huge-page policy. A sweep streams all of A, so with 4 KB pages it walks
+// 8 n^2 / 4096 pages; huge pages cut the TLB misses by 512x. "huge MB" is
+// what the kernel actually backed with 2 MB pages (THP or the hugetlb pool).
+void runHugePageBenchmarks(int n, int numThreads) {
+    cout << "\n=====================================================" << endl;
+    cout << "Huge pages (" << n << " x " << n << ", " << setprecision(1)
+         << 8.0 * n * (double)n / (1024.0 * 1024.0) << " MB matrix, " << numThreads
+         << " threads)" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(13) << "Policy" << setw(12) << "Huge MB" << setw(11) << "Fallback"
+         << setw(13) << "Sweep (ms)" << setw(10) << "GB/s" << setw(10) << "Gain" << endl;
+    
+    MemoryArena& arena = memoryArena();
+    const HugePages restore = arena.policy();
+    const int sweeps = max(5, (int)(2.0e8 / ((double)n * n)));
+    double baselineMs = 0.0;
+    vector<double> b(n);
+    for (HugePages policy : {HugePages::None, HugePages::Transparent, HugePages::Explicit}) {
+        arena.setPolicy(policy);
+        long long fallbacks = arena.stats().fallbacks;
+        size_t thpBefore = transparentHugeBytes();
+        DenseMatrix A(n, n, numThreads);
+        initializeSystem(A, b, n);
+        size_t hugeBytes = transparentHugeBytes() - min(thpBefore, transparentHugeBytes()) +
+                           arena.stats().explicitHugeBytes;
+        bool fellBack = arena.stats().fallbacks > fallbacks;
+        
+        // Best of three runs of `sweeps` sweeps (tolerance 0 never stops early)
+        double bestMs = 0.0;
+        for (int r = 0; r < 3; r++) {
+            vector<double> x(n, 0.0);
+            double start = omp_get_wtime();
+            jacobiParallel(A, b, x, n, 0.0, sweeps, numThreads);
+            double ms = (omp_get_wtime() - start) * 1000.0 / sweeps;
+            bestMs = r == 0 ? ms : min(bestMs, ms);
+        }
+        if (policy == HugePages::None) {
+            baselineMs = bestMs;
+        }
+        cout << setw(13) << hugePagesName(policy) << setw(12) << setprecision(1)
+             << hugeBytes / (1024.0 * 1024.0) << setw(11) << (fellBack ? "yes" : "no")
+             << setw(13) << setprecision(3) << bestMs << setw(10) << setprecision(2)
+             << 8.0 * n * (double)n / (bestMs * 1.0e6) << setw(9) << baselineMs / bestMs << "x"
+             << setprecision(6) << endl;
+    }
+    arena.setPolicy(restore);
+}
+
+// A stream of slightly perturbed systems (b_s = b * (1 + 1e-3 u), u in
+// [-1, 1)): fresh jacobiParallel calls vs one JacobiSolver that keeps its
+// workspace, cold (x = 0 each time) and warm-started from the last solution
+void runRepeatedSolveBenchmarks(int n, int numThreads, double tolerance, int maxIterations) {
+    const int numSolves = 8;
+    vector<double> b(n);
+    DenseMatrix A(n, n, numThreads);
+    initializeSystem(A, b, n);
+    
+    vector<vector<double>> rhs(numSolves, b);
+    for (int s = 0; s < numSolves; s++) {
+        CounterRng perturbRng(RngStream::Rhs, kSystemSeed + 1000 + s);
+        for (int i = 0; i < n; i++) {
+            double u = (double)perturbRng.uniformInt(i, 0, 2000) / 1000.0 - 1.0;
+            rhs[s][i] *= 1.0 + 1.0e-3 * u;
+        }
+    }
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Repeated solves (" << n << " x " << n << ", " << numSolves << " perturbed systems, "
+         << numThreads << " threads)" << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(22) << "Mode" << setw(14) << "Avg sweeps" << setw(15) << "Avg time(ms)"
+         << setw(14) << "Max resid" << endl;
+    
+    JacobiSolver solver(numThreads);
+    solver.setMatrix(A);
+    for (int mode = 0; mode < 3; mode++) {
+        const char* name = mode == 0 ? "jacobiParallel" : mode == 1 ? "JacobiSolver cold"
+                                                                     : "JacobiSolver warm";
+        solver.setWarmStart(mode == 2);
+        solver.resetSolution();
+        long long sweeps = 0;
+        double totalMs = 0.0, maxResidual = 0.0;
+        vector<double> x(n);
+        for (int s = 0; s < numSolves; s++) {
+            fill(x.begin(), x.end(), 0.0);
+            double start = omp_get_wtime();
+            if (mode == 0) {
+                sweeps += jacobiParallel(A, rhs[s], x, n, tolerance, maxIterations, numThreads);
+            } else {
+                sweeps += solver.solve(rhs[s], x, tolerance, maxIterations);
+            }
+            totalMs += (omp_get_wtime() - start) * 1000.0;
+            maxResidual = max(maxResidual, computeResidual(A, rhs[s], x, n));
+        }
+        cout << setw(22) << name << setw(14) << setprecision(1) << (double)sweeps / numSolves
+             << setw(15) << setprecision(3) << totalMs / numSolves << setw(14) << scientific
+             << maxResidual << fixed << setprecision(6) << endl;
+    }
+}
+
+// Cost of observing a solve: jacobiParallel without an observer, with
+// throttled progress reports, and with asynchronous checkpoints (offered
+// after every sweep, where most offers find the writer busy, and every
+// 50 ms). Then a restart check: a run stopped halfway and resumed from its
+// final checkpoint against the uninterrupted solve.
+void runCheckpointBenchmarks(int n, int numThreads, double tolerance, int maxIterations) {
+    const string path = "jacobi_checkpoint_bench.ckpt";
+    vector<double> b(n);
+    DenseMatrix A(n, n, numThreads);
+    initializeSystem(A, b, n);
+    const uint64_t fingerprint = systemFingerprint(b.data(), n);
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Progress and checkpoints (" << n << " x " << n << ", " << numThreads << " threads)"
+         << endl;
+    cout << "=====================================================" << endl;
+    cout << setw(20) << "Observer" << setw(12) << "Sweeps" << setw(12) << "Time (ms)"
+         << setw(12) << "Overhead" << setw(10) << "Reports" << setw(10) << "Written"
+         << setw(10) << "Skipped" << endl;
+    
+    vector<double> reference;
+    int referenceSweeps = 0;
+    double baseMs = 0.0;
+    for (int mode = 0; mode < 4; mode++) {
+        const char* name = mode == 0 ? "none" : mode == 1 ? "progress 10 ms"
+                         : mode == 2 ? "checkpoint/sweep" : "checkpoint 50 ms";
+        unique_ptr<AsyncCheckpointer> checkpointer;
+        if (mode >= 2) {
+            checkpointer.reset(new AsyncCheckpointer(path, fingerprint));
+        }
+        SolveObserver observer([](const SolveProgress&) {}, mode == 1 ? 0.01 : 1.0e9);
+        if (checkpointer) {
+            observer.setCheckpointer(checkpointer.get(), mode == 2 ? 0.0 : 0.05);
+        }
+        vector<double> x(n, 0.0);
+        double start = omp_get_wtime();
+        int sweeps = jacobiParallel(A, b, x, n, tolerance, maxIterations, numThreads,
+                                    ConvergencePolicy(), nullptr, mode == 0 ? nullptr : &observer);
+        double timeMs = (omp_get_wtime() - start) * 1000.0;
+        CheckpointStats cs;
+        if (checkpointer) {
+            checkpointer->flush();
+            cs = checkpointer->stats();
+        }
+        if (mode == 0) {
+            baseMs = timeMs;
+            reference = x;
+            referenceSweeps = sweeps;
+        }
+        cout << setw(20) << name << setw(12) << sweeps << setw(12) << setprecision(3) << timeMs
+             << setw(11) << setprecision(2) << timeMs / baseMs << "x" << setw(10)
+             << (mode == 0 ? 0 : observer.reports()) << setw(10) << cs.written << setw(10)
+             << cs.skipped << setprecision(6) << endl;
+        if (cs.failed) {
+            cout << "   checkpoint error: " << cs.lastError << endl;
+        }
+    }
+    
+    // Stop after half the sweeps (the final checkpoint is written on the
+    // way out), then resume from the file with the remaining budget
+    int firstLeg = max(1, referenceSweeps / 2);
+    vector<double> x(n, 0.0);
+    {
+        AsyncCheckpointer checkpointer(path, fingerprint);
+        SolveObserver observer;
+        observer.setCheckpointer(&checkpointer, 1.0e9);
+        jacobiParallel(A, b, x, n, tolerance, firstLeg, numThreads, ConvergencePolicy(), nullptr,
+                       &observer);
+    }
+    Checkpoint cp;
+    string error;
+    if (!loadCheckpoint(path, cp, error, fingerprint)) {
+        cout << "Restart check failed: " << error << endl;
+        remove(path.c_str());
+        return;
+    }
+    SolveObserver observer;
+    observer.setStartIteration(cp.iteration);
+    int resumed = jacobiParallel(A, b, cp.x, n, tolerance, maxIterations - cp.iteration,
+                                 numThreads, ConvergencePolicy(), nullptr, &observer);
+    double maxDx = 0.0;
+    for (int i = 0; i < n; i++) {
+        maxDx = max(maxDx, fabs(cp.x[i] - reference[i]));
+    }
+    cout << "Restart from sweep " << cp.iteration << ": " << cp.iteration + resumed
+         << " sweeps in total (uninterrupted " << referenceSweeps << "), max |dx| "
+         << scientific << setprecision(2) << maxDx << fixed << setprecision(6) << endl;
+    remove(path.c_str());
+}
+
+// Instrumented jacobiParallel run: per-phase times over all threads,
+// hardware counters where perf_event allows it, and the achieved bandwidth
+// against the STREAM triad measured at startup. The matrix is streamed once
+// per sweep, so 8 n^2 bytes per sweep is the model traffic; with counters the
+// LLC-miss traffic is shown next to it.
+void runInstrumentationReport(int n, int numThreads, double streamGBs) {
+    cout << "\n=====================================================" << endl;
+    cout << "Instrumentation (" << n << " x " << n << ", " << numThreads << " threads)" << endl;
+    cout << "=====================================================" << endl;
+    if (!instrumentationEnabled()) {
+        cout << "Disabled: rebuild with -DJACOBI_INSTRUMENT for per-phase timers," << endl;
+        cout << "hardware counters and the STREAM roofline" << endl;
+        return;
+    }
+    
+    DenseMatrix A(n, n, numThreads);
+    vector<double> b(n), x(n, 0.0);
+    initializeSystem(A, b, n);
+    const int sweeps = max(5, (int)(2.0e8 / ((double)n * n)));
+    
+    HardwareCounters counters(numThreads);
+    activeProfile().reset(numThreads);
+    counters.start();
+    double start = omp_get_wtime();
+    jacobiParallel(A, b, x, n, 0.0, sweeps, numThreads);
+    double elapsed = omp_get_wtime() - start;
+    CounterValues values = counters.stop();
+    
+    cout << "Sweeps: " << sweeps << ", total " << setprecision(3) << elapsed * 1000.0 << " ms"
+         << endl;
+    activeProfile().print(cout);
+    
+    double modelGBs = 8.0 * n * (double)n * sweeps / (elapsed * 1.0e9);
+    cout << "\nSTREAM triad:        " << setw(10) << streamGBs << " GB/s" << endl;
+    cout << "Achieved (model):    " << setw(10) << modelGBs << " GB/s  (" << setprecision(1)
+         << 100.0 * modelGBs / streamGBs << "% of STREAM)" << setprecision(3) << endl;
+    if (modelGBs > streamGBs) {
+        cout << "  (above STREAM: the matrix is served from cache, not memory)" << endl;
+    }
+    if (counters.available()) {
+        double missGBs = values.bytesFromMemory() / (elapsed * 1.0e9);
+        cout << "Achieved (LLC miss): " << setw(10) << missGBs << " GB/s  (" << setprecision(1)
+             << 100.0 * missGBs / streamGBs << "% of STREAM)" << setprecision(3) << endl;
+        cout << "Cycles: " << values.cycles << ", instructions: " << values.instructions
+             << ", IPC: " << setprecision(2)
+             << (values.cycles ? (double)values.instructions / values.cycles : 0.0)
+             << ", LLC misses: " << values.llcMisses << endl;
+    } else {
+        cout << "Hardware counters unavailable: " << counters.error() << endl;
+    }
+    cout << setprecision(6);
+    activeProfile().reset(0);
+}
+
+// b = A * ones for a loaded matrix (row sums), so the exact solution is all ones
+vector<double> onesRhs(const LoadedMatrix& M) {
+    int n = M.n();
+    bool dense = M.format == MatrixFormat::Dense;
+    vector<double> b(n, 0.0);
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < n; i++) {
         double sum = 0.0;
-        for (int j = 0; j < n; j++) {
-            sum += A[i][j] * x[j];
+        if (dense) {
+            const double* Ai = M.dense.rowPtr(i);
+            for (int j = 0; j < n; j++) {
+                sum += Ai[j];
+            }
+        } else {
+            for (int p = M.csr.rowPtr[i]; p < M.csr.rowPtr[i + 1]; p++) {
+                sum += M.csr.values[p];
+            }
         }
-        residual += (sum - b[i]) * (sum - b[i]);
+        b[i] = sum;
     }
-    return sqrt(residual);
+    return b;
+}
+
+// Solve a matrix loaded from disk with b = A * ones (exact solution all ones).
+// Dense files go through the dense jacobiParallel, coordinate files through
+// the CSR one; the tables match the synthetic dense benchmark.
+void runLoadedBenchmarks(const LoadedMatrix& M, const vector<int>& threadCounts, int maxThreads,
+                         double tolerance, int maxIterations) {
+    int n = M.n();
+    bool dense = M.format == MatrixFormat::Dense;
+    vector<double> b = onesRhs(M);
+    auto solve = [&](vector<double>& x, int numThreads) {
+        return dense ? jacobiParallel(M.dense, b, x, n, tolerance, maxIterations, numThreads)
+                     : jacobiParallel(M.csr, b, x, n, tolerance, maxIterations, numThreads);
+    };
+    auto residual = [&](const vector<double>& x) {
+        return dense ? computeResidual(M.dense, b, x, n) : computeResidual(M.csr, b, x, n);
+    };
+    double flopsPerSweep = 2.0 * (double)M.nnz();
+    
+    cout << "\n=====================================================" << endl;
+    cout << "Matrix size: " << n << " x " << n << endl;
+    cout << "=====================================================" << endl;
+    
+    double seqMs = 0.0;
+    {
+        vector<double> x(n, 0.0);
+        double start = omp_get_wtime();
+        int iterations = solve(x, 1);
+        seqMs = (omp_get_wtime() - start) * 1000.0;
+        cout << "\nSequential:" << endl;
+        cout << "  Iterations: " << iterations << endl;
+        cout << "  Time: " << seqMs << " ms" << endl;
+        cout << "  Residual: " << scientific << residual(x) << fixed << endl;
+        cout << "  GFLOP/s: " << setprecision(3) << flopsPerSweep * iterations / (seqMs * 1.0e6)
+             << setprecision(6) << endl;
+    }
+    
+    cout << "\nParallel (OpenMP):" << endl;
+    cout << "-----------------------------------------------------------------" << endl;
+    cout << setw(10) << "Threads" << setw(15) << "Time (ms)"
+         << setw(12) << "Speedup" << setw(15) << "Efficiency"
+         << setw(12) << "GFLOP/s" << endl;
+    cout << "-----------------------------------------------------------------" << endl;
+    for (int numThreads : threadCounts) {
+        if (numThreads > maxThreads) {
+            continue;
+        }
+        vector<double> x(n, 0.0);
+        double start = omp_get_wtime();
+        int iterations = solve(x, numThreads);
+        double timeMs = (omp_get_wtime() - start) * 1000.0;
+        double speedup = seqMs / timeMs;
+        cout << setw(10) << numThreads
+             << setw(15) << timeMs
+             << setw(12) << setprecision(2) << speedup
+             << setw(14) << speedup / numThreads * 100.0 << "%"
+             << setw(12) << setprecision(3) << flopsPerSweep * iterations / (timeMs * 1.0e6)
+             << setprecision(6) << endl;
+    }
+}
+
+// One long solve with a progress line every second and asynchronous
+// checkpoints of x; --restart resumes it from a checkpoint written for the
+// same system (same b), with the sweeps already done counted against
+// maxIterations. Solves the loaded matrix when there is one, otherwise the
+// synthetic system of size n.
+int runCheckpointedSolve(const LoadedMatrix* M, int n, int numThreads, double tolerance,
+                         int maxIterations, const string& checkpointPath,
+                         const string& restartPath, double checkpointInterval) {
+    DenseMatrix synthetic;
+    vector<double> b;
+    if (M) {
+        n = M->n();
+        b = onesRhs(*M);
+    } else {
+        synthetic = DenseMatrix(n, n, numThreads);
+        b.resize(n);
+        initializeSystem(synthetic, b, n);
+    }
+    const bool csr = M && M->format == MatrixFormat::Csr;
+    const DenseMatrix& A = M ? M->dense : synthetic;
+    const uint64_t fingerprint = systemFingerprint(b.data(), n);
+    
+    vector<double> x(n, 0.0);
+    int done = 0;
+    if (!restartPath.empty()) {
+        Checkpoint cp;
+        string error;
+        if (!loadCheckpoint(restartPath, cp, error, fingerprint)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        if ((int)cp.x.size() != n) {
+            cerr << "Error: " << restartPath << ": checkpoint has n = " << cp.x.size()
+                 << ", the system has n = " << n << endl;
+            return 1;
+        }
+        x.swap(cp.x);
+        done = cp.iteration;
+        cout << "\nResuming from " << restartPath << " at sweep " << done << " (diff "
+             << scientific << setprecision(3) << cp.diff << fixed << setprecision(6) << ")"
+             << endl;
+    }
+    
+    const string path = checkpointPath.empty() ? restartPath : checkpointPath;
+    cout << "\nCheckpointed solve: " << n << " x " << n << (csr ? " CSR" : " dense") << ", "
+         << numThreads << " threads, checkpoints to " << path << " every " << setprecision(1)
+         << checkpointInterval << " s" << setprecision(6) << endl;
+    AsyncCheckpointer checkpointer(path, fingerprint);
+    SolveObserver observer(
+        [](const SolveProgress& p) {
+            cout << "  sweep " << setw(7) << p.iteration << "  diff " << scientific
+                 << setprecision(3) << p.diff << fixed << "  " << setprecision(1)
+                 << p.elapsedSeconds << " s" << (p.final ? "  (end)" : "") << setprecision(6)
+                 << endl;
+        },
+        1.0);
+    observer.setCheckpointer(&checkpointer, checkpointInterval);
+    observer.setStartIteration(done);
+    
+    int budget = max(0, maxIterations - done);
+    double start = omp_get_wtime();
+    int sweeps = csr ? jacobiParallel(M->csr, b, x, n, tolerance, budget, numThreads, &observer)
+                     : jacobiParallel(A, b, x, n, tolerance, budget, numThreads,
+                                      ConvergencePolicy(), nullptr, &observer);
+    double timeMs = (omp_get_wtime() - start) * 1000.0;
+    checkpointer.flush();
+    CheckpointStats cs = checkpointer.stats();
+    
+    cout << "Sweeps: " << done + sweeps << " (" << sweeps << " in this run), time "
+         << setprecision(3) << timeMs << " ms, residual " << scientific
+         << (csr ? computeResidual(M->csr, b, x, n) : computeResidual(A, b, x, n)) << fixed
+         << setprecision(6) << endl;
+    cout << "Checkpoints written: " << cs.written << ", skipped (writer busy): " << cs.skipped
+         << endl;
+    if (cs.failed) {
+        cerr << "Error: " << cs.lastError << endl;
+        return 1;
+    }
+    return 0;
 }
 
-int main() {
-    // Problem sizes to test
+// Command-line options:
+//   --backend=cpu|device|all          solvers to run (default all)
+//   --affinity=none|compact|scatter   pin OpenMP threads (default none)
+//   --matrix=FILE                     solve a Matrix Market or binary matrix file
+//                                     instead of the synthetic systems
+//   --save-binary=FILE                write the loaded matrix in the binary format
+//   --huge-pages=default|none|transparent|explicit
+//                                     page policy of the matrix buffers
+//   --checkpoint=FILE                 one long solve with progress reports and
+//                                     asynchronous checkpoints of x to FILE
+//   --checkpoint-interval=SECONDS     time between checkpoints (default 10)
+//   --restart=FILE                    resume that solve from a checkpoint
+struct DriverOptions {
+    bool cpu = true;
+    bool device = true;
+    ThreadPlacement placement = ThreadPlacement::None;
+    HugePages hugePages = HugePages::Default;
+    string matrixPath;
+    string saveBinaryPath;
+    string checkpointPath;
+    string restartPath;
+    double checkpointInterval = 10.0;
+    int tiledMaxN = 16000; // largest n of the cache-blocking table
+    bool autotune = false;
+    bool autotunePrecision = false;
+    string tuningCachePath = "jacobi_tuning.cache";
     vector<int> sizes = {100, 500, 1000, 2000};
-    vector<int> threadCounts = {1, 2, 4, 8};
+    vector<int> threadCounts;  // empty = 1, 2, 4, ... up to the hardware threads
+    int warmup = 1;
+    int trials = 5;
+    string outputPath;         // structured results (.json or .csv)
+};
+
+// 1, 2, 4, ... below the available threads, plus the available count itself
+vector<int> defaultThreadCounts(int maxThreads) {
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(max(1, maxThreads));
+    return counts;
+}
+
+// Value of "--name=value" or "--name value" at argv[k], or nullptr
+const char* optionValue(int argc, char** argv, int& k, const char* name) {
+    size_t len = strlen(name);
+    if (strncmp(argv[k], name, len) != 0) {
+        return nullptr;
+    }
+    if (argv[k][len] == '=') {
+        return argv[k] + len + 1;
+    }
+    if (argv[k][len] == '\0' && k + 1 < argc) {
+        return argv[++k];
+    }
+    return nullptr;
+}
+
+bool parseOptions(int argc, char** argv, DriverOptions& opts) {
+    for (int k = 1; k < argc; k++) {
+        if (const char* value = optionValue(argc, argv, k, "--backend")) {
+            if (strcmp(value, "cpu") == 0) {
+                opts.cpu = true;
+                opts.device = false;
+            } else if (strcmp(value, "device") == 0) {
+                opts.cpu = false;
+                opts.device = true;
+            } else if (strcmp(value, "all") == 0) {
+                opts.cpu = true;
+                opts.device = true;
+            } else {
+                cerr << "Unknown backend: " << value << " (expected cpu, device or all)" << endl;
+                return false;
+            }
+        } else if (const char* value = optionValue(argc, argv, k, "--matrix")) {
+            opts.matrixPath = value;
+        } else if (const char* value = optionValue(argc, argv, k, "--save-binary")) {
+            opts.saveBinaryPath = value;
+        } else if (const char* value = optionValue(argc, argv, k, "--checkpoint-interval")) {
+            opts.checkpointInterval = atof(value);
+        } else if (const char* value = optionValue(argc, argv, k, "--checkpoint")) {
+            opts.checkpointPath = value;
+        } else if (const char* value = optionValue(argc, argv, k, "--restart")) {
+            opts.restartPath = value;
+        } else if (strcmp(argv[k], "--autotune") == 0) {
+            opts.autotune = true;
+        } else if (strcmp(argv[k], "--autotune-precision") == 0) {
+            opts.autotune = true;
+            opts.autotunePrecision = true;
+        } else if (const char* value = optionValue(argc, argv, k, "--sizes")) {
+            if (!parseIntList(value, opts.sizes)) {
+                cerr << "Invalid size list: " << value << " (expected e.g. 100,500,1000)" << endl;
+                return false;
+            }
+        } else if (const char* value = optionValue(argc, argv, k, "--threads")) {
+            if (!parseIntList(value, opts.threadCounts)) {
+                cerr << "Invalid thread list: " << value << " (expected e.g. 1,2,4)" << endl;
+                return false;
+            }
+        } else if (const char* value = optionValue(argc, argv, k, "--warmup")) {
+            opts.warmup = atoi(value);
+        } else if (const char* value = optionValue(argc, argv, k, "--trials")) {
+            opts.trials = atoi(value);
+        } else if (const char* value = optionValue(argc, argv, k, "--output")) {
+            opts.outputPath = value;
+        } else if (const char* value = optionValue(argc, argv, k, "--tuning-cache")) {
+            opts.tuningCachePath = value;
+        } else if (const char* value = optionValue(argc, argv, k, "--tiled-max-n")) {
+            opts.tiledMaxN = atoi(value);
+        } else if (const char* value = optionValue(argc, argv, k, "--affinity")) {
+            if (!parsePlacement(value, opts.placement)) {
+                cerr << "Unknown affinity: " << value << " (expected none, compact or scatter)"
+                     << endl;
+                return false;
+            }
+        } else if (const char* value = optionValue(argc, argv, k, "--huge-pages")) {
+            if (!parseHugePages(value, opts.hugePages)) {
+                cerr << "Unknown huge-page policy: " << value
+                     << " (expected default, none, transparent or explicit)" << endl;
+                return false;
+            }
+        } else {
+            cerr << "Unknown argument: " << argv[k] << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    DriverOptions opts;
+    if (!parseOptions(argc, argv, opts)) {
+        cerr << "Usage: " << argv[0]
+             << " [--backend=cpu|device|all] [--affinity=none|compact|scatter]"
+             << " [--huge-pages=default|none|transparent|explicit]"
+             << " [--matrix=FILE] [--save-binary=FILE] [--tiled-max-n=N]"
+             << " [--checkpoint=FILE] [--checkpoint-interval=SECONDS] [--restart=FILE]"
+             << " [--autotune | --autotune-precision] [--tuning-cache=FILE]"
+             << " [--sizes=N,N,...] [--threads=T,T,...] [--output=FILE.json|FILE.csv]"
+             << " [--warmup=N] [--trials=N]" << endl;
+        return 1;
+    }
+    
+    // Problem sizes and thread counts to test
+    vector<int> sizes = opts.sizes;
+    vector<int> threadCounts = opts.threadCounts.empty() ? defaultThreadCounts(omp_get_max_threads())
+                                                         : opts.threadCounts;
     double tolerance = 1e-6;
     int maxIterations = 10000;
+    double omegaWeighted = 0.67; // damping for weighted Jacobi
+    double omegaSor = 0.8;       // relaxation for red-black SOR
     
     int maxThreads = omp_get_max_threads();
+    CpuTopology topo = CpuTopology::detect();
+    memoryArena().setPolicy(opts.hugePages);
+    
+    // Threads are numbered the same in every team, so pinning the largest
+    // team once also pins the smaller ones
+    if (opts.placement != ThreadPlacement::None && !topo.pinThreads(maxThreads, opts.placement)) {
+        cerr << "Warning: thread pinning not supported on this platform" << endl;
+    }
     
     cout << "=============================================" << endl;
     cout << "  Jacobi Iterative Method - OpenMP Parallel" << endl;
     cout << "=============================================" << endl;
     cout << "Maximum available threads: " << maxThreads << endl;
+    cout << "Row kernel: " << activeRowDotKernel().name << " (available:";
+    for (const RowDotKernel& k : availableRowDotKernels()) {
+        cout << " " << k.name;
+    }
+    cout << ")" << endl;
+    cout << "Thread affinity: " << placementName(opts.placement) << endl;
+    cout << "Huge pages: " << hugePagesName(opts.hugePages) << endl;
+    topo.print(cout);
+    double streamGBs = 0.0;
+    if (instrumentationEnabled()) {
+        streamGBs = measureStreamTriad(maxThreads);
+        cout << "STREAM triad bandwidth: " << setprecision(2) << fixed << streamGBs << " GB/s"
+             << endl;
+    }
+    if (opts.device) {
+        cout << "Device backend: OpenMP target (" << deviceDescription() << ")" << endl;
+    }
     cout << fixed << setprecision(6);
     
+    const bool checkpointed = !opts.checkpointPath.empty() || !opts.restartPath.empty();
+    
+    // A matrix from disk replaces the synthetic benchmark
+    if (!opts.matrixPath.empty()) {
+        LoadedMatrix M;
+        string error;
+        double start = omp_get_wtime();
+        if (!loadMatrix(opts.matrixPath, M, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        double loadMs = (omp_get_wtime() - start) * 1000.0;
+        cout << "\nLoaded " << opts.matrixPath << ": "
+             << (M.format == MatrixFormat::Dense ? "dense" : "CSR") << ", " << M.n() << " x "
+             << M.n() << ", " << M.nnz() << " entries, " << setprecision(3) << loadMs << " ms"
+             << setprecision(6) << endl;
+        if (!opts.saveBinaryPath.empty()) {
+            if (!saveBinaryMatrix(opts.saveBinaryPath, M, error)) {
+                cerr << "Error: " << error << endl;
+                return 1;
+            }
+            cout << "Saved binary matrix to " << opts.saveBinaryPath << endl;
+        }
+        if (checkpointed) {
+            return runCheckpointedSolve(&M, M.n(), maxThreads, tolerance, maxIterations,
+                                        opts.checkpointPath, opts.restartPath,
+                                        opts.checkpointInterval);
+        }
+        runLoadedBenchmarks(M, threadCounts, maxThreads, tolerance, maxIterations);
+        return 0;
+    }
+    
+    // A checkpointed solve replaces the benchmark grid
+    if (checkpointed) {
+        return runCheckpointedSolve(nullptr, sizes.back(), maxThreads, tolerance, maxIterations,
+                                    opts.checkpointPath, opts.restartPath,
+                                    opts.checkpointInterval);
+    }
+    
+    // Structured output: repeated trials of the core variants only
+    if (!opts.outputPath.empty()) {
+        BenchmarkHarness harness(opts.warmup, opts.trials);
+        runHarnessBenchmarks(harness, sizes, threadCounts, maxThreads, tolerance, maxIterations,
+                             opts.device);
+        harness.addSection("memory", memoryJson(memoryArena().stats()));
+        string error;
+        if (!harness.write(opts.outputPath, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        cout << "\nWrote " << harness.records().size() << " results to " << opts.outputPath
+             << endl;
+        return 0;
+    }
+    
+    // Autotuning replaces the fixed benchmark grid
+    if (opts.autotune) {
+        int tuneThreads = min(maxThreads, *max_element(threadCounts.begin(), threadCounts.end()));
+        bool ok = runAutotuneBenchmarks(sizes, tuneThreads, tolerance, maxIterations,
+                                        opts.tuningCachePath, opts.autotunePrecision);
+        return ok ? 0 : 1;
+    }
+    
     // Store results for analysis
     vector<vector<double>> seqTimes(sizes.size());
     vector<vector<vector<double>>> parTimes(sizes.size());
+    vector<vector<ScalingSample>> scalingSamples(sizes.size());
+    vector<double> scalingT1Ms(sizes.size(), 0.0);
+    vector<pair<string, double>> variantGflops = {{"sequential", 0.0}, {"parallel", 0.0}};
     
     for (size_t s = 0; s < sizes.size(); s++) {
         int n = sizes[s];
@@ -168,10 +1951,14 @@ int main() {
         cout << "=====================================================" << endl;
         
         // Initialize system (same for all tests)
-        srand(42); // Fixed seed for reproducibility
-        vector<vector<double>> A(n, vector<double>(n));
+        // First touch by the parallel solver's thread layout, so each thread's
+        // block of rows lives on its own NUMA node
+        double setupStart = omp_get_wtime();
+        DenseMatrix A(n, n, min(maxThreads, threadCounts.back()));
         vector<double> b(n);
         initializeSystem(A, b, n);
+        cout << "System setup: " << setprecision(3) << (omp_get_wtime() - setupStart) * 1000.0
+             << " ms" << setprecision(6) << endl;
         
         // Sequential execution
         {
@@ -183,6 +1970,9 @@ int main() {
 
             double timeMs = (end - start) * 1000.0;
             seqTimes[s].push_back(timeMs);
+            scalingT1Ms[s] = timeMs;
+            variantGflops[0].second = max(variantGflops[0].second,
+                                          sweepGflops(n, iterations, timeMs));
             
             double residual = computeResidual(A, b, x, n);
             
@@ -190,14 +1980,108 @@ int main() {
             cout << "  Iterations: " << iterations << endl;
             cout << "  Time: " << timeMs << " ms" << endl;
             cout << "  Residual: " << scientific << residual << fixed << endl;
+            cout << "  GFLOP/s: " << setprecision(3) << sweepGflops(n, iterations, timeMs)
+                 << setprecision(6) << endl;
+        }
+        
+        // Device backend: whole solve resident on the accelerator
+        if (opts.device) {
+            vector<double> x(n, 0.0);
+            
+            double start = omp_get_wtime();
+            int iterations = jacobiDevice(A, b, x, n, tolerance, maxIterations);
+            double timeMs = (omp_get_wtime() - start) * 1000.0;
+            
+            cout << "\nDevice (OpenMP target):" << endl;
+            cout << "  Iterations: " << iterations << endl;
+            cout << "  Time: " << timeMs << " ms" << endl;
+            cout << "  Speedup: " << setprecision(2) << seqTimes[s][0] / timeMs << setprecision(6) << endl;
+            cout << "  Residual: " << scientific << computeResidual(A, b, x, n) << fixed << endl;
+            cout << "  GFLOP/s: " << setprecision(3) << sweepGflops(n, iterations, timeMs)
+                 << setprecision(6) << endl;
+        }
+        
+        if (!opts.cpu) {
+            continue;
+        }
+        
+        // Storage comparison: legacy vector-of-rows vs contiguous DenseMatrix
+        {
+            int numThreads = min(maxThreads, threadCounts.back());
+            vector<vector<double>> nestedA = A.toNested();
+            vector<double> xNested(n, 0.0), xDense(n, 0.0);
+            
+            double start = omp_get_wtime();
+            int itersNested = jacobiParallelNested(nestedA, b, xNested, n, tolerance,
+                                                   maxIterations, numThreads);
+            double nestedMs = (omp_get_wtime() - start) * 1000.0;
+            
+            start = omp_get_wtime();
+            int itersDense = jacobiParallel(A, b, xDense, n, tolerance, maxIterations, numThreads);
+            double denseMs = (omp_get_wtime() - start) * 1000.0;
+            
+            cout << "\nStorage layout (" << numThreads << " threads):" << endl;
+            cout << setprecision(3);
+            cout << "  vector<vector<double>>: " << nestedMs << " ms, "
+                 << sweepGflops(n, itersNested, nestedMs) << " GFLOP/s" << endl;
+            cout << "  DenseMatrix:            " << denseMs << " ms, "
+                 << sweepGflops(n, itersDense, denseMs) << " GFLOP/s" << endl;
+            cout << setprecision(6);
+        }
+        
+        // Split form A = D + R: D^-1 and R extracted once, shared by the
+        // sequential, parallel and device solvers
+        {
+            int numThreads = min(maxThreads, threadCounts.back());
+            double start = omp_get_wtime();
+            DenseSplit split = splitDense(A, numThreads);
+            double splitMs = (omp_get_wtime() - start) * 1000.0;
+            
+            cout << "\nSplit D^-1 + R (setup " << setprecision(3) << splitMs << " ms):" << endl;
+            cout << setw(22) << "Solver" << setw(14) << "A (ms)" << setw(14) << "D^-1+R (ms)"
+                 << setw(8) << "Gain" << setw(14) << "Residual" << endl;
+            for (int path = 0; path < 3; path++) {
+                if (path == 2 && !opts.device) {
+                    continue;
+                }
+                vector<double> xA(n, 0.0), xS(n, 0.0);
+                const char* name = path == 0 ? "sequential" : path == 1 ? "parallel" : "device";
+                start = omp_get_wtime();
+                if (path == 0) {
+                    jacobiSequential(A, b, xA, n, tolerance, maxIterations);
+                } else if (path == 1) {
+                    jacobiParallel(A, b, xA, n, tolerance, maxIterations, numThreads);
+                } else {
+                    jacobiDevice(A, b, xA, n, tolerance, maxIterations);
+                }
+                double plainMs = (omp_get_wtime() - start) * 1000.0;
+                start = omp_get_wtime();
+                if (path == 0) {
+                    jacobiSequential(split, b, xS, n, tolerance, maxIterations);
+                } else if (path == 1) {
+                    jacobiParallel(split, b, xS, n, tolerance, maxIterations, numThreads);
+                } else {
+                    jacobiDevice(split, b, xS, n, tolerance, maxIterations);
+                }
+                double splitSolveMs = (omp_get_wtime() - start) * 1000.0;
+                cout << setw(22) << name << setw(14) << plainMs << setw(14) << splitSolveMs
+                     << setw(7) << setprecision(2) << plainMs / splitSolveMs << "x"
+                     << setw(14) << scientific << computeResidual(A, b, xS, n) << fixed
+                     << setprecision(3) << endl;
+            }
+            cout << setprecision(6);
         }
         
         // Parallel execution with different thread counts
         cout << "\nParallel (OpenMP):" << endl;
-        cout << "-----------------------------------------------------" << endl;
+        cout << "-----------------------------------------------------------------" << endl;
         cout << setw(10) << "Threads" << setw(15) << "Time (ms)" 
-             << setw(12) << "Speedup" << setw(15) << "Efficiency" << endl;
-        cout << "-----------------------------------------------------" << endl;
+             << setw(12) << "Speedup" << setw(15) << "Efficiency"
+             << setw(12) << "GFLOP/s" << endl;
+        cout << "-----------------------------------------------------------------" << endl;
+        
+        vector<int> runThreads;
+        vector<double> forkJoinMs, persistentMs;
         
         for (size_t t = 0; t < threadCounts.size(); t++) {
             int numThreads = threadCounts[t];
@@ -215,8 +2099,19 @@ int main() {
 
             double timeMs = (end - start) * 1000.0;
             parTimes[s][t].push_back(timeMs);
+            scalingSamples[s].push_back({numThreads, timeMs});
+            if (numThreads == 1) {
+                scalingT1Ms[s] = timeMs;
+            }
+            variantGflops[1].second = max(variantGflops[1].second,
+                                          sweepGflops(n, iterations, timeMs));
             
-            double residual = computeResidual(A, b, x, n);
+            vector<double> xPersistent(n, 0.0);
+            start = omp_get_wtime();
+            jacobiParallelPersistent(A, b, xPersistent, n, tolerance, maxIterations, numThreads);
+            runThreads.push_back(numThreads);
+            forkJoinMs.push_back(timeMs);
+            persistentMs.push_back((omp_get_wtime() - start) * 1000.0);
             
             // Calculate speedup and efficiency
             double speedup = seqTimes[s][0] / timeMs;
@@ -225,8 +2120,255 @@ int main() {
             cout << setw(10) << numThreads 
                  << setw(15) << timeMs
                  << setw(12) << setprecision(2) << speedup
-                 << setw(14) << efficiency << "%" << setprecision(6) << endl;
+                 << setw(14) << efficiency << "%"
+                 << setw(12) << setprecision(3) << sweepGflops(n, iterations, timeMs)
+                 << setprecision(6) << endl;
+        }
+        
+        // Amortised convergence checks at the largest thread count
+        {
+            int numThreads = runThreads.empty() ? 1 : runThreads.back();
+            struct PolicyCase { const char* name; ConvergencePolicy policy; };
+            vector<PolicyCase> cases = {
+                {"every sweep", {1, false, 64}},
+                {"every 4", {4, false, 64}},
+                {"every 16", {16, false, 64}},
+                {"adaptive", {1, true, 64}},
+            };
+            int baselineIters = 0;
+            
+            cout << "\nConvergence check interval (" << numThreads << " threads):" << endl;
+            cout << setw(14) << "Policy" << setw(12) << "Iterations" << setw(9) << "Checks"
+                 << setw(8) << "Extra" << setw(11) << "Est.extra" << setw(13) << "Time (ms)" << endl;
+            for (const PolicyCase& c : cases) {
+                vector<double> x(n, 0.0);
+                ConvergenceStats st;
+                double start = omp_get_wtime();
+                int iterations = jacobiParallel(A, b, x, n, tolerance, maxIterations,
+                                                numThreads, c.policy, &st);
+                double timeMs = (omp_get_wtime() - start) * 1000.0;
+                if (baselineIters == 0) {
+                    baselineIters = iterations;
+                }
+                cout << setw(14) << c.name << setw(12) << iterations << setw(9) << st.checks
+                     << setw(8) << iterations - baselineIters << setw(11) << st.estimatedExtraSweeps
+                     << setw(13) << setprecision(3) << timeMs << setprecision(6) << endl;
+            }
+        }
+        
+        // Stopping on the relative residual, fused into the check sweeps,
+        // against max-diff stopping followed by a separate residual pass
+        {
+            int numThreads = runThreads.empty() ? 1 : runThreads.back();
+            const double residualTolerance = 1e-8;
+            struct StopCase { const char* name; double tolerance; ConvergencePolicy policy; };
+            vector<StopCase> cases = {
+                {"max diff", tolerance, {}},
+                {"rel. residual", residualTolerance, {1, false, 64, StopCriterion::RelativeResidual}},
+                {"rel. resid. adapt", residualTolerance,
+                 {1, true, 64, StopCriterion::RelativeResidual}},
+            };
+            
+            cout << "\nStopping criterion (" << numThreads << " threads):" << endl;
+            cout << setw(18) << "Criterion" << setw(11) << "Tolerance" << setw(12) << "Iterations"
+                 << setw(9) << "Checks" << setw(13) << "Time (ms)" << setw(14) << "||r||/||b||"
+                 << endl;
+            vector<double> x(n);
+            for (const StopCase& c : cases) {
+                fill(x.begin(), x.end(), 0.0);
+                ConvergenceStats st;
+                double start = omp_get_wtime();
+                int iterations = jacobiParallel(A, b, x, n, c.tolerance, maxIterations,
+                                                numThreads, c.policy, &st);
+                double timeMs = (omp_get_wtime() - start) * 1000.0;
+                cout << setw(18) << c.name << setw(11) << scientific << setprecision(0)
+                     << c.tolerance << fixed << setw(12) << iterations << setw(9) << st.checks
+                     << setw(13) << setprecision(3) << timeMs << setw(14) << scientific
+                     << computeRelativeResidual(A, b, x, n) << fixed << setprecision(6) << endl;
+            }
+            
+            // A separate residual pass per check would read A a second time
+            double start = omp_get_wtime();
+            computeResidual(A, b, x, n);
+            double residualMs = (omp_get_wtime() - start) * 1000.0;
+            cout << "  Separate residual pass: " << setprecision(3) << residualMs
+                 << " ms (fused into the sweep: no extra pass over A)" << setprecision(6) << endl;
+        }
+        
+        // Time to solution of every method side by side
+        {
+            int numThreads = runThreads.empty() ? 1 : runThreads.back();
+            cout << "\nMethod comparison (" << numThreads << " threads):" << endl;
+            cout << setw(18) << "Method" << setw(8) << "Omega" << setw(12) << "Iterations"
+                 << setw(13) << "Time (ms)" << setw(12) << "ms/iter" << setw(14) << "Residual" << endl;
+            for (int method = 0; method < 4; method++) {
+                vector<double> x(n, 0.0);
+                const char* name = "Jacobi";
+                double omega = 1.0;
+                double start = omp_get_wtime();
+                int iterations = 0;
+                if (method == 0) {
+                    iterations = jacobiParallel(A, b, x, n, tolerance, maxIterations, numThreads);
+                } else if (method == 1) {
+                    name = "Weighted Jacobi";
+                    omega = omegaWeighted;
+                    iterations = jacobiParallelWeighted(A, b, x, n, tolerance, maxIterations,
+                                                        numThreads, omega);
+                } else if (method == 2) {
+                    name = "RB Gauss-Seidel";
+                    iterations = jacobiParallelRedBlack(A, b, x, n, tolerance, maxIterations,
+                                                        numThreads, omega);
+                } else {
+                    name = "RB SOR";
+                    omega = omegaSor;
+                    iterations = jacobiParallelRedBlack(A, b, x, n, tolerance, maxIterations,
+                                                        numThreads, omega);
+                }
+                double timeMs = (omp_get_wtime() - start) * 1000.0;
+                double residual = computeResidual(A, b, x, n);
+                cout << setw(18) << name << setw(8) << setprecision(2) << omega
+                     << setw(12) << iterations << setw(13) << setprecision(3) << timeMs
+                     << setw(12) << timeMs / iterations << setw(14) << scientific << residual
+                     << fixed << setprecision(6) << endl;
+            }
         }
+        
+        // Storage precision of A: time, achieved bandwidth and accuracy
+        {
+            int numThreads = runThreads.empty() ? 1 : runThreads.back();
+            MixedPrecisionMatrix<float> Af = convertPrecision<float>(A, numThreads);
+            MixedPrecisionMatrix<bfloat16> Ab = convertPrecision<bfloat16>(A, numThreads);
+            
+            cout << "\nPrecision of A (" << numThreads << " threads, x and sums in double):" << endl;
+            cout << setw(20) << "Storage" << setw(12) << "Iterations" << setw(13) << "Time (ms)"
+                 << setw(10) << "GB/s" << setw(14) << "Residual" << endl;
+            for (int mode = 0; mode < 5; mode++) {
+                vector<double> x(n, 0.0);
+                RefinementStats st;
+                const char* name = "double";
+                size_t sweepBytes = A.bytes();
+                double start = omp_get_wtime();
+                int sweeps = 0;
+                if (mode == 0) {
+                    sweeps = jacobiParallel(A, b, x, n, tolerance, maxIterations, numThreads);
+                } else if (mode == 1) {
+                    name = "float";
+                    sweepBytes = Af.A.bytes();
+                    sweeps = jacobiParallelMixed(Af, b, x, n, tolerance, maxIterations, numThreads);
+                } else if (mode == 2) {
+                    name = "bfloat16";
+                    sweepBytes = Ab.A.bytes();
+                    sweeps = jacobiParallelMixed(Ab, b, x, n, tolerance, maxIterations, numThreads);
+                } else if (mode == 3) {
+                    name = "float + refine";
+                    sweepBytes = Af.A.bytes();
+                    sweeps = jacobiMixedRefined(A, Af, b, x, n, tolerance, maxIterations,
+                                                numThreads, &st);
+                } else {
+                    name = "bfloat16 + refine";
+                    sweepBytes = Ab.A.bytes();
+                    sweeps = jacobiMixedRefined(A, Ab, b, x, n, tolerance, maxIterations,
+                                                numThreads, &st);
+                }
+                double timeMs = (omp_get_wtime() - start) * 1000.0;
+                // Matrix traffic: every sweep streams A once, every refinement
+                // step also reads the double A for its residual
+                double bytes = (double)sweepBytes * sweeps + (double)A.bytes() * st.refinements;
+                cout << setw(20) << name << setw(12) << sweeps << setw(13) << setprecision(3)
+                     << timeMs << setw(10) << bytes / (timeMs * 1.0e6) << setw(14) << scientific
+                     << computeResidual(A, b, x, n) << fixed << setprecision(6) << endl;
+            }
+        }
+        
+        // Many right-hand sides against the same A: one batched solve vs
+        // k separate jacobiParallel calls, both as warmup + median of trials
+        {
+            int numThreads = runThreads.empty() ? 1 : runThreads.back();
+            BenchmarkHarness timing(opts.warmup, opts.trials);
+            
+            cout << "\nBatched right-hand sides (" << numThreads << " threads, median of "
+                 << timing.trials() << " trials):" << endl;
+            cout << setw(6) << "RHS" << setw(9) << "Sweeps" << setw(12) << "Col-sweeps"
+                 << setw(13) << "Time (ms)" << setw(11) << "ms/rhs" << setw(10) << "GFLOP/s"
+                 << setw(16) << "Separate (ms)" << setw(8) << "Gain" << setw(14) << "Max resid" << endl;
+            for (int k : {1, 4, 16}) {
+                if ((long long)n * k > 16000) {
+                    continue; // keep the benchmark run short for large n
+                }
+                // Right-hand side c (row c of B) is generated with seed + c
+                DenseMatrix B(k, n), X(k, n);
+                for (int c = 0; c < k; c++) {
+                    CounterRng rhsRng(RngStream::Rhs, kSystemSeed + c);
+                    for (int i = 0; i < n; i++) {
+                        B(c, i) = (double)rhsRng.uniformInt(i, 0, 100) / 10.0;
+                    }
+                }
+                BatchedStats st;
+                int sweeps = 0;
+                TrialStats batched = timing.measure([&]() {
+                    std::memset(X.data(), 0, X.bytes());
+                    return jacobiParallelBatched(A, B, X, n, k, tolerance, maxIterations,
+                                                 numThreads, &st);
+                }, &sweeps);
+                double timeMs = batched.median;
+                
+                double maxResidual = 0.0;
+                for (int c = 0; c < k; c++) {
+                    vector<double> bc(B.rowPtr(c), B.rowPtr(c) + n);
+                    vector<double> xc(X.rowPtr(c), X.rowPtr(c) + n);
+                    maxResidual = max(maxResidual, computeResidual(A, bc, xc, n));
+                }
+                
+                // Baseline: the same k right-hand sides solved one at a time
+                vector<vector<double>> rhs(k), xs(k);
+                for (int c = 0; c < k; c++) {
+                    rhs[c].assign(B.rowPtr(c), B.rowPtr(c) + n);
+                }
+                double separateMs = timing.measure([&]() {
+                    int total = 0;
+                    for (int c = 0; c < k; c++) {
+                        xs[c].assign(n, 0.0);
+                        total += jacobiParallel(A, rhs[c], xs[c], n, tolerance, maxIterations,
+                                                numThreads);
+                    }
+                    return total;
+                }).median;
+                
+                double gflops = 2.0 * n * (double)n * st.columnSweeps / (timeMs * 1.0e6);
+                cout << setw(6) << k << setw(9) << sweeps << setw(12) << st.columnSweeps
+                     << setw(13) << setprecision(3) << timeMs << setw(11) << timeMs / k
+                     << setw(10) << gflops << setw(16) << separateMs << setw(7) << setprecision(2)
+                     << separateMs / timeMs << "x" << setw(14) << scientific << maxResidual
+                     << fixed << setprecision(6) << endl;
+            }
+        }
+        
+        cout << "\nFork/join per sweep vs persistent region:" << endl;
+        cout << setw(10) << "Threads" << setw(18) << "Fork/join (ms)"
+             << setw(18) << "Persistent (ms)" << setw(10) << "Gain" << endl;
+        for (size_t t = 0; t < runThreads.size(); t++) {
+            cout << setw(10) << runThreads[t] << setw(18) << forkJoinMs[t]
+                 << setw(18) << persistentMs[t] << setw(9) << setprecision(2)
+                 << forkJoinMs[t] / persistentMs[t] << "x" << setprecision(6) << endl;
+        }
+    }
+    
+    if (opts.cpu) {
+        runSparseBenchmarks(threadCounts, maxThreads, tolerance, maxIterations);
+        runSkewedSparseBenchmarks(threadCounts, maxThreads, tolerance, maxIterations);
+        runStencilBenchmarks(threadCounts, maxThreads, tolerance, maxIterations);
+        runNumaBenchmarks(topo, threadCounts, maxThreads, sizes.back(), tolerance, maxIterations,
+                          opts.placement);
+        runRepeatedSolveBenchmarks(sizes[sizes.size() / 2], min(maxThreads, threadCounts.back()),
+                                   tolerance, maxIterations);
+        runCheckpointBenchmarks(sizes[sizes.size() / 2], min(maxThreads, threadCounts.back()),
+                                tolerance, maxIterations);
+        runAsyncBenchmarks(sizes.back(), threadCounts, maxThreads, tolerance, maxIterations);
+        runSmallSystemBenchmarks(tolerance, maxIterations);
+        runSystemBatchBenchmarks(min(maxThreads, threadCounts.back()), tolerance, maxIterations);
+        runHugePageBenchmarks(sizes.back(), min(maxThreads, threadCounts.back()));
+        runTiledBenchmarks(min(maxThreads, threadCounts.back()), opts.tiledMaxN);
+        runInstrumentationReport(sizes.back(), min(maxThreads, threadCounts.back()), streamGBs);
     }
     
     // Summary Analysis
@@ -255,11 +2397,20 @@ int main() {
     cout << "   - The Jacobi method is well-suited for parallelization" << endl;
     cout << "     because each row can be computed independently" << endl;
     
-    cout << "\n4. AMDAHL'S LAW CONSIDERATION:" << endl;
-    cout << "   Maximum Speedup = 1 / (s + (1-s)/P)" << endl;
-    cout << "   where s = serial fraction, P = number of processors" << endl;
-    cout << "   - Convergence check and copy operations are serial" << endl;
-    cout << "   - These limit the maximum achievable speedup" << endl;
+    cout << "\n4. SCALING MODEL (fitted to the parallel tables):" << endl;
+    cout << "   s = serial fraction, Smax = bandwidth-saturated speedup," << endl;
+    cout << "   c = fork/join and synchronisation cost per extra thread" << endl;
+    if (opts.cpu) {
+        printScalingModel(sizes, scalingSamples, scalingT1Ms, maxThreads);
+        
+        cout << "\n5. ROOFLINE:" << endl;
+        printRoofline(measureRoofline(maxThreads), variantGflops);
+    } else {
+        cout << "   (CPU backend not run)" << endl;
+    }
+    
+    cout << "\n6. MEMORY (aligned arena):" << endl;
+    printMemoryStats(memoryArena().stats());
     
     cout << "\n=============================================" << endl;
     
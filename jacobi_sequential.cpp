@@ -9,28 +9,36 @@
 #include <chrono>
 #include <iomanip>
 
+#include "dense_matrix.h"
+#include "counter_rng.h"
+
 using namespace std;
 using namespace std::chrono;
 
-// Function to initialize a diagonally dominant matrix (ensures convergence)
-void initializeSystem(vector<vector<double>>& A, vector<double>& b, int n) {
+// Function to initialize a diagonally dominant matrix (ensures convergence).
+// Same counter-based generator as jacobi_parallel, so both solve the same system.
+void initializeSystem(DenseMatrix& A, vector<double>& b, int n, uint64_t seed = kSystemSeed) {
+    CounterRng matrixRng(RngStream::Matrix, seed);
+    CounterRng rhsRng(RngStream::Rhs, seed);
+    
     // Create a diagonally dominant matrix for convergence
     for (int i = 0; i < n; i++) {
+        double* Ai = A.rowPtr(i);
         double rowSum = 0.0;
         for (int j = 0; j < n; j++) {
             if (i != j) {
-                A[i][j] = (double)(rand() % 10) / 10.0; // Small off-diagonal values
-                rowSum += fabs(A[i][j]);
+                Ai[j] = (double)matrixRng.uniformInt(i, j, 10) / 10.0; // Small off-diagonal values
+                rowSum += fabs(Ai[j]);
             }
         }
         // Make diagonal element dominant
-        A[i][i] = rowSum + (double)(rand() % 10 + 1);
-        b[i] = (double)(rand() % 100) / 10.0;
+        Ai[i] = rowSum + (double)(matrixRng.uniformInt(i, i, 10) + 1);
+        b[i] = (double)rhsRng.uniformInt(i, 0, 100) / 10.0;
     }
 }
 
 // Sequential Jacobi Iterative Method
-int jacobiSequential(const vector<vector<double>>& A, const vector<double>& b,
+int jacobiSequential(const DenseMatrix& A, const vector<double>& b,
                      vector<double>& x, int n, double tolerance, int maxIterations) {
     vector<double> x_new(n, 0.0);
     int iterations = 0;
@@ -40,17 +48,18 @@ int jacobiSequential(const vector<vector<double>>& A, const vector<double>& b,
         
         // Update each element
         for (int i = 0; i < n; i++) {
+            const double* Ai = A.rowPtr(i);
             double sigma = 0.0;
             
             // Sum of A[i][j] * x[j] for j != i
             for (int j = 0; j < n; j++) {
                 if (j != i) {
-                    sigma += A[i][j] * x[j];
+                    sigma += Ai[j] * x[j];
                 }
             }
             
             // Jacobi formula: x_new[i] = (b[i] - sigma) / A[i][i]
-            x_new[i] = (b[i] - sigma) / A[i][i];
+            x_new[i] = (b[i] - sigma) / Ai[i];
             
             // Track maximum difference for convergence check
             double diff = fabs(x_new[i] - x[i]);
@@ -59,10 +68,8 @@ int jacobiSequential(const vector<vector<double>>& A, const vector<double>& b,
             }
         }
         
-        // Copy x_new to x
-        for (int i = 0; i < n; i++) {
-            x[i] = x_new[i];
-        }
+        // Swap buffers: x_new becomes the current iterate, no copy pass
+        x.swap(x_new);
         
         iterations++;
         
@@ -76,13 +83,14 @@ int jacobiSequential(const vector<vector<double>>& A, const vector<double>& b,
 }
 
 // Function to verify solution by computing residual ||Ax - b||
-double computeResidual(const vector<vector<double>>& A, const vector<double>& b,
+double computeResidual(const DenseMatrix& A, const vector<double>& b,
                        const vector<double>& x, int n) {
     double residual = 0.0;
     for (int i = 0; i < n; i++) {
+        const double* Ai = A.rowPtr(i);
         double sum = 0.0;
         for (int j = 0; j < n; j++) {
-            sum += A[i][j] * x[j];
+            sum += Ai[j] * x[j];
         }
         residual += (sum - b[i]) * (sum - b[i]);
     }
@@ -100,11 +108,9 @@ int main() {
     cout << "=============================================" << endl;
     cout << fixed << setprecision(6);
     
-    srand(42); // Fixed seed for reproducibility
-    
     for (int n : sizes) {
         // Initialize system
-        vector<vector<double>> A(n, vector<double>(n));
+        DenseMatrix A(n, n);
         vector<double> b(n);
         vector<double> x(n, 0.0); // Initial guess
         
@@ -125,6 +131,8 @@ int main() {
         cout << "  Iterations: " << iterations << endl;
         cout << "  Time: " << timeMs << " ms" << endl;
         cout << "  Residual: " << scientific << residual << fixed << endl;
+        cout << "  GFLOP/s: " << setprecision(3)
+             << 2.0 * n * (double)n * iterations / (timeMs * 1.0e6) << setprecision(6) << endl;
     }
     
     cout << "\n=============================================" << endl;
@@ -0,0 +1,194 @@
+/*
+ * Reusable Jacobi Solver
+ * Solver object for streams of related systems: no per-solve allocation,
+ * cached inverse diagonal, warm start from the previous solution
+ *
+ * jacobiParallel allocates x_new, builds its reducer and sets the global
+ * thread count on every call. JacobiSolver does that work once:
+ *   - the two iterates and 1/A_ii live in one aligned workspace (rows of a
+ *     DenseMatrix, so each starts on a cache line), sized when the matrix is
+ *     bound and reused by every later solve of the same size
+ *   - the per-thread max-diff slots are allocated with the solver
+ *   - each solve is one persistent parallel region with num_threads(), so
+ *     the runtime hands back the same team every call and the global
+ *     omp_set_num_threads state is never touched
+ * With warm start enabled a solve begins from the previous solution instead
+ * of the caller's x, which for slightly perturbed systems needs only the
+ * sweeps to absorb the perturbation rather than a full solve.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <omp.h>
+
+#include "convergence.h"
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+#include "solve_progress.h"
+#include "thread_reduction.h"
+
+class JacobiSolver {
+public:
+    explicit JacobiSolver(int numThreads, const ConvergencePolicy& policy = ConvergencePolicy())
+        : numThreads_(std::max(1, numThreads)), policy_(policy), maxDiff_(numThreads_),
+          residual_(numThreads_), dot_(activeRowDotKernel().fn) {}
+
+    // Bind A (not copied; it must outlive the solves) and cache 1/A_ii. The
+    // workspace is only reallocated when the size changes, so re-binding a
+    // perturbed matrix of the same size costs one pass over the diagonal.
+    void setMatrix(const DenseMatrix& A) {
+        int n = A.rows();
+        if (n != n_) {
+            n_ = n;
+            work_ = DenseMatrix(3, n, numThreads_);
+            hasSolution_ = false;
+        }
+        A_ = &A;
+
+        double* invDiag = work_.rowPtr(kInvDiag);
+        #pragma omp parallel for schedule(static) num_threads(numThreads_)
+        for (int i = 0; i < n; i++) {
+            invDiag[i] = 1.0 / A(i, i);
+        }
+    }
+
+    // Start each solve from the previous solution (when there is one)
+    void setWarmStart(bool enabled) { warmStart_ = enabled; }
+    bool warmStart() const { return warmStart_; }
+
+    // Forget the previous solution; the next solve starts from the caller's x
+    void resetSolution() { hasSolution_ = false; }
+    bool hasSolution() const { return hasSolution_; }
+
+    // Report progress / checkpoint through `observer` (nullptr: none); it is
+    // called from the single that records each check sweep
+    void setObserver(SolveObserver* observer) { observer_ = observer; }
+
+    int size() const { return n_; }
+    int numThreads() const { return numThreads_; }
+    const ConvergenceStats& stats() const { return stats_; }
+
+    // Latest solution (valid after a solve, n entries)
+    const double* solution() const { return work_.rowPtr(current_); }
+
+    // Solve A x = b. The initial guess is the previous solution under warm
+    // start, otherwise x; the result is written to x (resized to n if needed).
+    // Returns the number of sweeps.
+    int solve(const std::vector<double>& b, std::vector<double>& x, double tolerance,
+              int maxIterations) {
+        const int n = n_;
+        if (!A_ || n == 0) {
+            return 0;
+        }
+        x.resize(n, 0.0);
+        if (!(warmStart_ && hasSolution_)) {
+            std::copy(x.begin(), x.end(), work_.rowPtr(current_));
+        }
+
+        const DenseMatrix& A = *A_;
+        const double* invDiag = work_.rowPtr(kInvDiag);
+        const double* rhs = b.data();
+        RowDotFn dot = dot_;
+        ConvergenceMonitor monitor(policy_, tolerance);
+        const bool residualStop = policy_.criterion == StopCriterion::RelativeResidual;
+        const double normB =
+            residualStop ? residualScale(parallelNorm2(rhs, n, residual_)) : 1.0;
+        residual_.reset(0.0);
+        int iterations = 0;
+        int finalBuffer = current_;
+        SolveObserver* observer = observer_;
+        if (observer) {
+            observer->start();
+        }
+
+        #pragma omp parallel num_threads(numThreads_)
+        {
+            int cur = current_;
+            int iter = 0;
+            bool done = false;
+
+            while (!done && iter < maxIterations) {
+                const double* xCur = work_.rowPtr(cur);
+                double* xNext = work_.rowPtr(1 - cur);
+                // The monitor only changes inside the single below, which is
+                // followed by a barrier, so every thread sees the same answer
+                bool check = monitor.isCheckSweep(iter + 1);
+
+                if (check) {
+                    double localMax = 0.0;
+                    double localResidual = 0.0;
+                    #pragma omp for schedule(static) nowait
+                    for (int i = 0; i < n; i++) {
+                        double sigma = dot(A.rowPtr(i), xCur, n) - A(i, i) * xCur[i];
+                        xNext[i] = (rhs[i] - sigma) * invDiag[i];
+                        localMax = std::max(localMax, std::fabs(xNext[i] - xCur[i]));
+                        double r = jacobiRowResidual(xNext[i], xCur[i], A(i, i));
+                        localResidual += r * r;
+                    }
+                    maxDiff_.publishMax(localMax);
+                    residual_.publishSum(localResidual);
+                    #pragma omp barrier
+
+                    #pragma omp single
+                    {
+                        double measure = residualStop ? std::sqrt(residual_.sum()) / normB
+                                                      : maxDiff_.max();
+                        stop_ = monitor.record(iter + 1, measure);
+                        if (observer) {
+                            observer->observe(iter + 1, measure, xNext, n);
+                        }
+                        maxDiff_.reset(0.0);
+                        residual_.reset(0.0);
+                    }
+                    done = stop_;
+                } else {
+                    #pragma omp for schedule(static)
+                    for (int i = 0; i < n; i++) {
+                        double sigma = dot(A.rowPtr(i), xCur, n) - A(i, i) * xCur[i];
+                        xNext[i] = (rhs[i] - sigma) * invDiag[i];
+                    }
+                }
+
+                cur = 1 - cur;
+                iter++;
+            }
+
+            #pragma omp master
+            {
+                iterations = iter;
+                finalBuffer = cur;
+            }
+        }
+
+        current_ = finalBuffer;
+        hasSolution_ = true;
+        std::copy(solution(), solution() + n, x.begin());
+        stats_ = monitor.stats();
+        if (observer) {
+            observer->finish(iterations, stats_.finalDiff, solution(), n);
+        }
+        return iterations;
+    }
+
+private:
+    static constexpr int kInvDiag = 2; // workspace row holding 1/A_ii
+
+    int numThreads_;
+    ConvergencePolicy policy_;
+    ThreadReducer maxDiff_;
+    ThreadReducer residual_; // per-thread sums of squared row residuals
+    RowDotFn dot_;
+    SolveObserver* observer_ = nullptr;
+
+    const DenseMatrix* A_ = nullptr;
+    int n_ = 0;
+    DenseMatrix work_;   // rows 0/1: iterates, row 2: inverse diagonal
+    int current_ = 0;    // workspace row holding the latest iterate
+    bool warmStart_ = false;
+    bool hasSolution_ = false;
+    bool stop_ = false;  // shared convergence decision inside a solve
+    ConvergenceStats stats_;
+};
@@ -0,0 +1,622 @@
+/*
+ * Matrix Input / Output
+ * Matrix Market (.mtx) loader with a parallel parser, and a native binary
+ * format that is memory-mapped instead of parsed
+ *
+ * Matrix Market: "coordinate" files load as CSR, "array" files as dense.
+ * real / integer / pattern fields and general / symmetric / skew-symmetric
+ * storage are supported. The body is split into one chunk per thread at
+ * line boundaries; a counting pass gives every chunk its entry offset, so
+ * the parse pass writes straight into the final arrays.
+ *
+ * Binary format (native endianness, 64-byte aligned arrays):
+ *   MatrixFileHeader (128 bytes)
+ *   dense: rows * stride doubles, rows padded exactly like DenseMatrix
+ *   csr:   rowPtr (n + 1 int32), colIdx (nnz int32), values (nnz double),
+ *          diag (n double)
+ * A dense file is mapped copy-on-write and the DenseMatrix adopts the
+ * mapping, so loading costs only page faults. CsrMatrix owns std::vector
+ * storage, so a CSR file is mapped and its arrays copied in parallel.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#if defined(_WIN32)
+#include <iterator>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "dense_matrix.h"
+#include "sparse_matrix.h"
+
+enum class MatrixFormat { Dense = 1, Csr = 2 };
+
+// A square system matrix read from disk, in the storage its file uses
+struct LoadedMatrix {
+    MatrixFormat format = MatrixFormat::Dense;
+    DenseMatrix dense;
+    CsrMatrix csr;
+
+    int n() const { return format == MatrixFormat::Dense ? dense.rows() : csr.n; }
+    long long nnz() const {
+        return format == MatrixFormat::Dense ? (long long)dense.rows() * dense.cols() : csr.nnz();
+    }
+};
+
+struct MatrixFileHeader {
+    char magic[8];        // "JACOBIMX"
+    uint32_t version;     // kMatrixFileVersion
+    uint32_t endianTag;   // 0x01020304 as written by the producing machine
+    uint32_t format;      // MatrixFormat
+    uint32_t reserved;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t nnz;         // stored entries (dense: rows * cols)
+    uint64_t stride;      // dense row stride in doubles
+    uint64_t offsets[4];  // byte offsets of the arrays listed above
+    uint8_t padding[40];
+};
+
+static_assert(sizeof(MatrixFileHeader) == 128, "MatrixFileHeader must stay 128 bytes");
+
+constexpr char kMatrixFileMagic[8] = {'J', 'A', 'C', 'O', 'B', 'I', 'M', 'X'};
+constexpr uint32_t kMatrixFileVersion = 1;
+constexpr uint32_t kMatrixFileEndianTag = 0x01020304u;
+
+// Read-only view of a whole file: mmap'd on POSIX (copy-on-write, so the
+// pages may be written through an adopted DenseMatrix), read into an
+// aligned buffer elsewhere
+class MappedFile {
+public:
+    static std::shared_ptr<MappedFile> open(const std::string& path, std::string& error) {
+        std::shared_ptr<MappedFile> file(new MappedFile());
+#if defined(_WIN32)
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            error = "cannot open " + path;
+            return nullptr;
+        }
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        file->size_ = bytes.size();
+        file->data_ = static_cast<char*>(_aligned_malloc(std::max<size_t>(file->size_, 1), 4096));
+        std::memcpy(file->data_, bytes.data(), file->size_);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "cannot open " + path;
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            error = "cannot stat " + path;
+            return nullptr;
+        }
+        file->size_ = (size_t)st.st_size;
+        if (file->size_ > 0) {
+            void* p = mmap(nullptr, file->size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                error = "cannot map " + path;
+                return nullptr;
+            }
+            file->data_ = static_cast<char*>(p);
+        }
+        ::close(fd);
+#endif
+        return file;
+    }
+
+    ~MappedFile() {
+#if defined(_WIN32)
+        _aligned_free(data_);
+#else
+        if (data_) {
+            munmap(data_, size_);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+namespace matrix_io_detail {
+
+inline size_t alignUp(size_t v) { return (v + 63) / 64 * 64; }
+
+// True if `count` elements of `elemSize` bytes at byte `offset` lie inside a
+// file of `fileSize` bytes and the offset is a multiple of `align` (the
+// scalar type's size); written so that no product or sum can wrap
+inline bool arrayInFile(size_t fileSize, uint64_t offset, uint64_t count, size_t elemSize,
+                        size_t align) {
+    return offset % align == 0 && offset <= fileSize && count <= (fileSize - offset) / elemSize;
+}
+
+// Next token in [p, end) as a null-terminated copy; advances p
+inline bool nextToken(const char*& p, const char* end, char* token, size_t capacity) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    size_t len = 0;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+        if (len + 1 < capacity) {
+            token[len++] = *p;
+        }
+        p++;
+    }
+    token[len] = '\0';
+    return len > 0;
+}
+
+inline bool isBlankLine(const char* p, const char* end) {
+    for (; p < end && *p != '\n'; p++) {
+        if (*p != ' ' && *p != '\t' && *p != '\r') {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline const char* lineEnd(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return nl ? nl : end;
+}
+
+// One parsed Matrix Market entry (0-based indices)
+struct Entry {
+    int row;
+    int col;
+    double value;
+};
+
+} // namespace matrix_io_detail
+
+// Parse a Matrix Market file into `out`; numThreads <= 0 uses all threads
+inline bool loadMatrixMarket(const std::string& path, LoadedMatrix& out, std::string& error,
+                             int numThreads = 0) {
+    using namespace matrix_io_detail;
+
+    std::shared_ptr<MappedFile> file = MappedFile::open(path, error);
+    if (!file) {
+        return false;
+    }
+    const char* p = file->data();
+    const char* end = p + file->size();
+
+    // Banner: %%MatrixMarket matrix <coordinate|array> <field> <symmetry>
+    const char* eol = lineEnd(p, end);
+    std::string banner(p, eol);
+    std::transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+    char object[32] = {}, layout[32] = {}, field[32] = {}, symmetry[32] = {};
+    if (std::sscanf(banner.c_str(), "%%%%matrixmarket %31s %31s %31s %31s", object, layout, field,
+                    symmetry) != 4 || std::strcmp(object, "matrix") != 0) {
+        error = path + ": not a Matrix Market matrix file";
+        return false;
+    }
+    bool coordinate = std::strcmp(layout, "coordinate") == 0;
+    if (!coordinate && std::strcmp(layout, "array") != 0) {
+        error = path + ": unknown layout " + layout;
+        return false;
+    }
+    bool pattern = std::strcmp(field, "pattern") == 0;
+    if (!pattern && std::strcmp(field, "real") != 0 && std::strcmp(field, "integer") != 0 &&
+        std::strcmp(field, "double") != 0) {
+        error = path + ": unsupported field " + field;
+        return false;
+    }
+    bool symmetric = std::strcmp(symmetry, "symmetric") == 0;
+    bool skew = std::strcmp(symmetry, "skew-symmetric") == 0;
+    if (!symmetric && !skew && std::strcmp(symmetry, "general") != 0) {
+        error = path + ": unsupported symmetry " + symmetry;
+        return false;
+    }
+
+    // Comments, then the size line
+    p = eol < end ? eol + 1 : end;
+    while (p < end && (*p == '%' || isBlankLine(p, end))) {
+        eol = lineEnd(p, end);
+        p = eol < end ? eol + 1 : end;
+    }
+    eol = lineEnd(p, end);
+    long long rows = 0, cols = 0, entries = 0;
+    std::string sizeLine(p, eol);
+    int fields = std::sscanf(sizeLine.c_str(), "%lld %lld %lld", &rows, &cols, &entries);
+    if (fields < (coordinate ? 3 : 2)) {
+        error = path + ": malformed size line";
+        return false;
+    }
+    if (rows != cols || rows <= 0) {
+        error = path + ": Jacobi needs a square matrix";
+        return false;
+    }
+    if (!coordinate) {
+        entries = (symmetric || skew) ? rows * (rows + 1) / 2 - (skew ? rows : 0) : rows * cols;
+    }
+    const char* body = eol < end ? eol + 1 : end;
+    int n = (int)rows;
+
+    // Split the body at line boundaries, one chunk per thread
+    int threads = numThreads > 0 ? numThreads : omp_get_max_threads();
+    std::vector<const char*> bounds(threads + 1, end);
+    bounds[0] = body;
+    for (int t = 1; t < threads; t++) {
+        const char* q = body + (size_t)(end - body) * t / threads;
+        q = std::max(q, bounds[t - 1]);
+        eol = lineEnd(q, end);
+        bounds[t] = q == body || q[-1] == '\n' ? q : (eol < end ? eol + 1 : end);
+    }
+
+    // Pass 1: entries per chunk; pass 2: parse into the final positions
+    std::vector<long long> chunkStart(threads + 1, 0);
+    #pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int t = 0; t < threads; t++) {
+        long long count = 0;
+        for (const char* q = bounds[t]; q < bounds[t + 1];) {
+            const char* e = lineEnd(q, bounds[t + 1]);
+            count += !isBlankLine(q, e) && *q != '%';
+            q = e + 1;
+        }
+        chunkStart[t + 1] = count;
+    }
+    for (int t = 0; t < threads; t++) {
+        chunkStart[t + 1] += chunkStart[t];
+    }
+    if (chunkStart[threads] != entries) {
+        error = path + ": expected " + std::to_string(entries) + " entries, found " +
+                std::to_string(chunkStart[threads]);
+        return false;
+    }
+
+    std::vector<Entry> parsed((size_t)entries);
+    bool ok = true;
+    #pragma omp parallel for schedule(static, 1) num_threads(threads) reduction(&&:ok)
+    for (int t = 0; t < threads; t++) {
+        long long k = chunkStart[t];
+        char token[64];
+        for (const char* q = bounds[t]; q < bounds[t + 1];) {
+            const char* e = lineEnd(q, bounds[t + 1]);
+            if (isBlankLine(q, e) || *q == '%') {
+                q = e + 1;
+                continue;
+            }
+            Entry entry{0, 0, 1.0};
+            const char* c = q;
+            if (coordinate) {
+                ok = ok && nextToken(c, e, token, sizeof(token));
+                entry.row = std::atoi(token) - 1;
+                ok = ok && nextToken(c, e, token, sizeof(token));
+                entry.col = std::atoi(token) - 1;
+                ok = ok && entry.row >= 0 && entry.row < n && entry.col >= 0 && entry.col < n;
+            }
+            if (!pattern) {
+                ok = ok && nextToken(c, e, token, sizeof(token));
+                entry.value = std::strtod(token, nullptr);
+            }
+            parsed[k++] = entry;
+            q = e + 1;
+        }
+    }
+    if (!ok) {
+        error = path + ": malformed entry";
+        return false;
+    }
+
+    if (!coordinate) {
+        // Column-major values (lower triangle only for symmetric storage)
+        out.format = MatrixFormat::Dense;
+        out.dense = DenseMatrix(n, n);
+        DenseMatrix& A = out.dense;
+        bool packed = symmetric || skew;
+        #pragma omp parallel for schedule(static) num_threads(threads)
+        for (int j = 0; j < n; j++) {
+            int first = packed ? j + (skew ? 1 : 0) : 0;
+            long long offset = !packed ? (long long)j * n
+                             : skew ? (long long)j * (2LL * n - j - 1) / 2
+                                    : (long long)j * (2LL * n - j + 1) / 2;
+            for (int i = first; i < n; i++) {
+                A(i, j) = parsed[offset + (i - first)].value;
+            }
+        }
+        if (packed) {
+            // Mirror the upper triangle (rows of distinct threads never overlap)
+            #pragma omp parallel for schedule(static) num_threads(threads)
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    A(i, j) = skew ? -A(j, i) : A(j, i);
+                }
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            if (A(i, i) == 0.0) {
+                error = path + ": zero diagonal in row " + std::to_string(i + 1);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Coordinate -> CSR: count per row, scatter, then sort each row
+    out.format = MatrixFormat::Csr;
+    CsrMatrix& A = out.csr;
+    A.n = n;
+    A.rowPtr.assign(n + 1, 0);
+    for (const Entry& e : parsed) {
+        A.rowPtr[e.row + 1]++;
+        if ((symmetric || skew) && e.row != e.col) {
+            A.rowPtr[e.col + 1]++;
+        }
+    }
+    std::partial_sum(A.rowPtr.begin(), A.rowPtr.end(), A.rowPtr.begin());
+    A.colIdx.assign(A.rowPtr[n], 0);
+    A.values.assign(A.rowPtr[n], 0.0);
+    std::vector<int> fill(A.rowPtr.begin(), A.rowPtr.end() - 1);
+    for (const Entry& e : parsed) {
+        int slot = fill[e.row]++;
+        A.colIdx[slot] = e.col;
+        A.values[slot] = e.value;
+        if ((symmetric || skew) && e.row != e.col) {
+            slot = fill[e.col]++;
+            A.colIdx[slot] = e.row;
+            A.values[slot] = skew ? -e.value : e.value;
+        }
+    }
+
+    A.diag.assign(n, 0.0);
+    std::vector<std::pair<int, double>> row;
+    #pragma omp parallel for schedule(dynamic, 256) num_threads(threads) private(row)
+    for (int i = 0; i < n; i++) {
+        row.clear();
+        for (int q = A.rowPtr[i]; q < A.rowPtr[i + 1]; q++) {
+            row.emplace_back(A.colIdx[q], A.values[q]);
+        }
+        std::sort(row.begin(), row.end(),
+                  [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                      return a.first < b.first;
+                  });
+        for (size_t k = 0; k < row.size(); k++) {
+            A.colIdx[A.rowPtr[i] + k] = row[k].first;
+            A.values[A.rowPtr[i] + k] = row[k].second;
+            if (row[k].first == i) {
+                A.diag[i] += row[k].second;
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (A.diag[i] == 0.0) {
+            error = path + ": zero diagonal in row " + std::to_string(i + 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace matrix_io_detail {
+
+inline MatrixFileHeader makeHeader(MatrixFormat format) {
+    MatrixFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMatrixFileMagic, sizeof(h.magic));
+    h.version = kMatrixFileVersion;
+    h.endianTag = kMatrixFileEndianTag;
+    h.format = (uint32_t)format;
+    return h;
+}
+
+inline void writeAt(std::ofstream& out, size_t offset, const void* data, size_t bytes) {
+    out.seekp((std::streamoff)offset);
+    out.write(static_cast<const char*>(data), (std::streamsize)bytes);
+}
+
+} // namespace matrix_io_detail
+
+// Write A in the native binary format
+inline bool saveBinaryMatrix(const std::string& path, const DenseMatrix& A, std::string& error) {
+    using namespace matrix_io_detail;
+    MatrixFileHeader h = makeHeader(MatrixFormat::Dense);
+    h.rows = A.rows();
+    h.cols = A.cols();
+    h.nnz = (uint64_t)A.rows() * A.cols();
+    h.stride = A.stride();
+    h.offsets[0] = alignUp(sizeof(h));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    writeAt(out, 0, &h, sizeof(h));
+    writeAt(out, h.offsets[0], A.data(), A.bytes());
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+inline bool saveBinaryMatrix(const std::string& path, const CsrMatrix& A, std::string& error) {
+    using namespace matrix_io_detail;
+    MatrixFileHeader h = makeHeader(MatrixFormat::Csr);
+    h.rows = A.n;
+    h.cols = A.n;
+    h.nnz = (uint64_t)A.nnz();
+    h.offsets[0] = alignUp(sizeof(h));
+    h.offsets[1] = alignUp(h.offsets[0] + (A.n + 1) * sizeof(int));
+    h.offsets[2] = alignUp(h.offsets[1] + h.nnz * sizeof(int));
+    h.offsets[3] = alignUp(h.offsets[2] + h.nnz * sizeof(double));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    writeAt(out, 0, &h, sizeof(h));
+    writeAt(out, h.offsets[0], A.rowPtr.data(), (A.n + 1) * sizeof(int));
+    writeAt(out, h.offsets[1], A.colIdx.data(), h.nnz * sizeof(int));
+    writeAt(out, h.offsets[2], A.values.data(), h.nnz * sizeof(double));
+    writeAt(out, h.offsets[3], A.diag.data(), A.n * sizeof(double));
+    if (!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+inline bool saveBinaryMatrix(const std::string& path, const LoadedMatrix& A, std::string& error) {
+    return A.format == MatrixFormat::Dense ? saveBinaryMatrix(path, A.dense, error)
+                                           : saveBinaryMatrix(path, A.csr, error);
+}
+
+// True if the file starts with the binary format's magic
+inline bool isBinaryMatrixFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[8] = {};
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, kMatrixFileMagic, sizeof(magic)) == 0;
+}
+
+// Map a binary matrix file; dense data is adopted without a copy
+inline bool loadBinaryMatrix(const std::string& path, LoadedMatrix& out, std::string& error) {
+    using namespace matrix_io_detail;
+    std::shared_ptr<MappedFile> file = MappedFile::open(path, error);
+    if (!file) {
+        return false;
+    }
+    MatrixFileHeader h;
+    if (file->size() < sizeof(h)) {
+        error = path + ": truncated header";
+        return false;
+    }
+    std::memcpy(&h, file->data(), sizeof(h));
+    if (std::memcmp(h.magic, kMatrixFileMagic, sizeof(h.magic)) != 0) {
+        error = path + ": not a binary matrix file";
+        return false;
+    }
+    if (h.version != kMatrixFileVersion || h.endianTag != kMatrixFileEndianTag) {
+        error = path + ": unsupported version or byte order";
+        return false;
+    }
+    if (h.rows != h.cols) {
+        error = path + ": Jacobi needs a square matrix";
+        return false;
+    }
+    // rowPtr holds n + 1 ints and nnz int offsets
+    if (h.rows >= (uint64_t)INT_MAX || h.nnz > (uint64_t)INT_MAX) {
+        error = path + ": rows or nonzeros exceed INT_MAX";
+        return false;
+    }
+    int n = (int)h.rows;
+    const size_t size = file->size();
+
+    if (h.format == (uint32_t)MatrixFormat::Dense) {
+        if (h.stride < h.cols || h.stride > size / sizeof(double) ||
+            !arrayInFile(size, h.offsets[0], h.rows, h.stride * sizeof(double), sizeof(double))) {
+            error = path + ": truncated data";
+            return false;
+        }
+        double* data = reinterpret_cast<double*>(file->data() + h.offsets[0]);
+        out.format = MatrixFormat::Dense;
+        out.dense = DenseMatrix::adopt(data, n, n, h.stride, file);
+        if (out.dense.empty()) {
+            error = path + ": row stride or alignment does not match DenseMatrix";
+            return false;
+        }
+        for (int i = 0; i < n; i++) {
+            if (out.dense(i, i) == 0.0) {
+                out.dense = DenseMatrix();
+                error = path + ": zero diagonal in row " + std::to_string(i + 1);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (h.format != (uint32_t)MatrixFormat::Csr) {
+        error = path + ": unknown storage format";
+        return false;
+    }
+    if (!arrayInFile(size, h.offsets[0], h.rows + 1, sizeof(int), sizeof(int)) ||
+        !arrayInFile(size, h.offsets[1], h.nnz, sizeof(int), sizeof(int)) ||
+        !arrayInFile(size, h.offsets[2], h.nnz, sizeof(double), sizeof(double)) ||
+        !arrayInFile(size, h.offsets[3], h.rows, sizeof(double), sizeof(double))) {
+        error = path + ": truncated data";
+        return false;
+    }
+    const int nnz = (int)h.nnz;
+    CsrMatrix A;
+    A.n = n;
+    A.rowPtr.resize(n + 1);
+    A.colIdx.resize(nnz);
+    A.values.resize(nnz);
+    A.diag.resize(n);
+    const char* base = file->data();
+    std::memcpy(A.rowPtr.data(), base + h.offsets[0], (n + 1) * sizeof(int));
+    std::memcpy(A.diag.data(), base + h.offsets[3], n * sizeof(double));
+
+    // The row copies below are bounded by rowPtr, so it must be a valid
+    // partition of [0, nnz) before anything is copied
+    if (A.rowPtr[0] != 0 || A.rowPtr[n] != nnz) {
+        error = path + ": row pointers do not span the nonzeros";
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (A.rowPtr[i + 1] < A.rowPtr[i]) {
+            error = path + ": row pointers decrease at row " + std::to_string(i + 1);
+            return false;
+        }
+        if (A.diag[i] == 0.0) {
+            error = path + ": zero diagonal in row " + std::to_string(i + 1);
+            return false;
+        }
+    }
+
+    // Large arrays: parallel copy by the solver's row partition, checking
+    // the column indices on the way
+    const int* cols = reinterpret_cast<const int*>(base + h.offsets[1]);
+    const double* vals = reinterpret_cast<const double*>(base + h.offsets[2]);
+    int badRow = INT_MAX;
+    #pragma omp parallel for schedule(static) reduction(min:badRow)
+    for (int i = 0; i < n; i++) {
+        int begin = A.rowPtr[i], len = A.rowPtr[i + 1] - begin;
+        std::memcpy(A.colIdx.data() + begin, cols + begin, len * sizeof(int));
+        std::memcpy(A.values.data() + begin, vals + begin, len * sizeof(double));
+        for (int p = begin; p < begin + len; p++) {
+            if (A.colIdx[p] < 0 || A.colIdx[p] >= n) {
+                badRow = std::min(badRow, i);
+            }
+        }
+    }
+    if (badRow != INT_MAX) {
+        error = path + ": column index out of range in row " + std::to_string(badRow + 1);
+        return false;
+    }
+    out.format = MatrixFormat::Csr;
+    out.csr = std::move(A);
+    return true;
+}
+
+// Load either format, recognised by the binary magic
+inline bool loadMatrix(const std::string& path, LoadedMatrix& out, std::string& error) {
+    return isBinaryMatrixFile(path) ? loadBinaryMatrix(path, out, error)
+                                    : loadMatrixMarket(path, out, error);
+}
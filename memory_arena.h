@@ -0,0 +1,292 @@
+/*
+ * Memory Arena
+ * Aligned buffers with optional 2 MB huge pages and allocation statistics
+ *
+ * Every matrix buffer of the solvers (dense A and its workspaces through
+ * BasicDenseMatrix, the CSR / SELL arrays through AlignedVector) comes from
+ * the process-wide arena. A buffer is always 64-byte aligned; one of at
+ * least a huge page is mapped with mmap at a 2 MB boundary and rounded up to
+ * whole huge pages, so that a multi-GB dense A is covered by 2 MB TLB
+ * entries instead of hundreds of thousands of 4 KB ones. The page policy:
+ *   default      mmap without advice; the kernel's THP setting decides
+ *   none         MADV_NOHUGEPAGE, the 4 KB baseline
+ *   transparent  MADV_HUGEPAGE, THP backs the buffer when it can
+ *   explicit     MAP_HUGETLB from the reserved pool (vm.nr_hugepages);
+ *                falls back to transparent when the pool is too small
+ * Smaller buffers and other platforms use the C aligned allocator. Whether
+ * a buffer went through mmap depends only on its size, so release() needs
+ * no per-buffer header and the policy may change between allocations.
+ *
+ * The arena counts allocations, live and peak bytes, the bytes placed on
+ * explicit huge pages and the fallbacks; transparentHugeBytes() reads how
+ * much anonymous memory the kernel actually backs with THP.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+enum class HugePages { Default, None, Transparent, Explicit };
+
+inline const char* hugePagesName(HugePages p) {
+    switch (p) {
+    case HugePages::None: return "none";
+    case HugePages::Transparent: return "transparent";
+    case HugePages::Explicit: return "explicit";
+    default: return "default";
+    }
+}
+
+inline bool parseHugePages(const char* name, HugePages& p) {
+    if (std::strcmp(name, "default") == 0) {
+        p = HugePages::Default;
+    } else if (std::strcmp(name, "none") == 0) {
+        p = HugePages::None;
+    } else if (std::strcmp(name, "transparent") == 0) {
+        p = HugePages::Transparent;
+    } else if (std::strcmp(name, "explicit") == 0) {
+        p = HugePages::Explicit;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct MemoryStats {
+    long long allocations = 0;
+    long long releases = 0;
+    long long mappedAllocations = 0; // buffers of at least one huge page
+    long long fallbacks = 0;         // explicit requests served without MAP_HUGETLB
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+    size_t totalBytes = 0;           // over all allocations
+    size_t explicitHugeBytes = 0;    // live bytes on MAP_HUGETLB pages
+};
+
+class MemoryArena {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kHugePageSize = (size_t)2 << 20;
+
+    HugePages policy() const { return policy_.load(std::memory_order_relaxed); }
+    void setPolicy(HugePages p) { policy_.store(p, std::memory_order_relaxed); }
+
+    // kAlignment-aligned buffer of `bytes` (contents unspecified); throws
+    // std::bad_alloc on failure
+    void* allocate(size_t bytes) {
+        if (bytes == 0) {
+            return nullptr;
+        }
+        bool hugeTlb = false;
+        void* p = mapped(bytes) ? map(bytes, hugeTlb) : smallAllocate(bytes);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(bytes, std::memory_order_relaxed);
+        size_t live = live_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t peak = peak_.load(std::memory_order_relaxed);
+        while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+        if (hugeTlb) {
+            explicitHuge_.fetch_add(roundToHugePages(bytes), std::memory_order_relaxed);
+        }
+        return p;
+    }
+
+    // Release a buffer from allocate(); `bytes` must be the requested size
+    void release(void* p, size_t bytes) {
+        if (!p) {
+            return;
+        }
+        releases_.fetch_add(1, std::memory_order_relaxed);
+        live_.fetch_sub(bytes, std::memory_order_relaxed);
+#if defined(__linux__)
+        if (mapped(bytes)) {
+            if (isHugeTlb(p)) {
+                explicitHuge_.fetch_sub(roundToHugePages(bytes), std::memory_order_relaxed);
+            }
+            munmap(p, roundToHugePages(bytes));
+            return;
+        }
+#endif
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    MemoryStats stats() const {
+        MemoryStats s;
+        s.allocations = allocations_.load(std::memory_order_relaxed);
+        s.releases = releases_.load(std::memory_order_relaxed);
+        s.mappedAllocations = mappedAllocations_.load(std::memory_order_relaxed);
+        s.fallbacks = fallbacks_.load(std::memory_order_relaxed);
+        s.liveBytes = live_.load(std::memory_order_relaxed);
+        s.peakBytes = peak_.load(std::memory_order_relaxed);
+        s.totalBytes = total_.load(std::memory_order_relaxed);
+        s.explicitHugeBytes = explicitHuge_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    // Restart the peak from the live bytes (e.g. per benchmark section)
+    void resetPeak() { peak_.store(live_.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+private:
+    static size_t roundToHugePages(size_t bytes) {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    static bool mapped(size_t bytes) {
+#if defined(__linux__)
+        return bytes >= kHugePageSize;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static void* smallAllocate(size_t bytes) {
+        size_t size = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+#if defined(_MSC_VER)
+        return _aligned_malloc(size, kAlignment);
+#else
+        return std::aligned_alloc(kAlignment, size);
+#endif
+    }
+
+#if defined(__linux__)
+    void* map(size_t bytes, bool& hugeTlb) {
+        const size_t length = roundToHugePages(bytes);
+        mappedAllocations_.fetch_add(1, std::memory_order_relaxed);
+        HugePages p = policy();
+        if (p == HugePages::Explicit) {
+#ifdef MAP_HUGETLB
+            void* q = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (q != MAP_FAILED) {
+                hugeTlb = true;
+                rememberHugeTlb(q);
+                return q;
+            }
+#endif
+            fallbacks_.fetch_add(1, std::memory_order_relaxed);
+            p = HugePages::Transparent;
+        }
+        // Over-map by one huge page and trim both ends to a 2 MB boundary
+        void* raw = mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            return nullptr;
+        }
+        uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        if (aligned > begin) {
+            munmap(raw, aligned - begin);
+        }
+        size_t tail = begin + length + kHugePageSize - (aligned + length);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        void* q = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        if (p == HugePages::Transparent) {
+            madvise(q, length, MADV_HUGEPAGE);
+        } else if (p == HugePages::None) {
+            madvise(q, length, MADV_NOHUGEPAGE);
+        }
+#endif
+        return q;
+    }
+
+    // MAP_HUGETLB buffers are few (one per large matrix), a short list is enough
+    void rememberHugeTlb(void* p) {
+        std::lock_guard<std::mutex> lock(hugeTlbLock_);
+        hugeTlb_.push_back(p);
+    }
+
+    bool isHugeTlb(void* p) {
+        std::lock_guard<std::mutex> lock(hugeTlbLock_);
+        auto it = std::find(hugeTlb_.begin(), hugeTlb_.end(), p);
+        if (it == hugeTlb_.end()) {
+            return false;
+        }
+        hugeTlb_.erase(it);
+        return true;
+    }
+
+    std::mutex hugeTlbLock_;
+    std::vector<void*> hugeTlb_;
+#else
+    void* map(size_t, bool&) { return nullptr; }
+#endif
+
+    std::atomic<HugePages> policy_{HugePages::Default};
+    std::atomic<long long> allocations_{0};
+    std::atomic<long long> releases_{0};
+    std::atomic<long long> mappedAllocations_{0};
+    std::atomic<long long> fallbacks_{0};
+    std::atomic<size_t> live_{0};
+    std::atomic<size_t> peak_{0};
+    std::atomic<size_t> total_{0};
+    std::atomic<size_t> explicitHuge_{0};
+};
+
+// Process-wide arena all solver buffers are allocated from
+inline MemoryArena& memoryArena() {
+    static MemoryArena arena;
+    return arena;
+}
+
+// Anonymous memory of this process the kernel backs with transparent huge
+// pages (AnonHugePages of /proc/self/smaps_rollup); 0 where unavailable
+inline size_t transparentHugeBytes() {
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string key;
+    size_t kb = 0;
+    while (in >> key) {
+        if (key == "AnonHugePages:") {
+            in >> kb;
+            return kb * 1024;
+        }
+        in.ignore(1 << 12, '\n');
+    }
+    return 0;
+}
+
+// Standard allocator over memoryArena(), for std::vector members that hold
+// matrix data
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(memoryArena().allocate(count * sizeof(T))); }
+    void deallocate(T* p, size_t count) { memoryArena().release(p, count * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
@@ -0,0 +1,289 @@
+/*
+ * Mixed-Precision Jacobi
+ * A stored in float or bfloat16, x and all accumulation in double
+ *
+ * The dense sweep is bound by streaming A, so halving (float) or quartering
+ * (bfloat16) its size cuts the time per sweep by about as much. x, b, the
+ * diagonal and every sum stay in double; only the off-diagonal coefficients
+ * carry the storage rounding, which converges to the solution of the rounded
+ * system. Iterative refinement restores double accuracy:
+ *     r = b - A x        (A in double)
+ *     solve A_low d = r  (mixed sweeps)
+ *     x = x + d
+ * until the correction is below the tolerance.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+#include "thread_reduction.h"
+
+// bfloat16: the upper 16 bits of an IEEE float (8-bit exponent, 7-bit mantissa)
+struct bfloat16 {
+    uint16_t bits;
+};
+
+inline float toFloat(bfloat16 h) {
+    uint32_t u = (uint32_t)h.bits << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// Round to nearest even
+inline bfloat16 toBfloat16(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    if ((u & 0x7fffffffu) > 0x7f800000u) {
+        return {0x7fc0}; // NaN
+    }
+    u += 0x7fffu + ((u >> 16) & 1u);
+    return {(uint16_t)(u >> 16)};
+}
+
+inline double widen(double v) { return v; }
+inline double widen(float v) { return v; }
+inline double widen(bfloat16 v) { return toFloat(v); }
+
+template <typename T> T narrow(double v);
+template <> inline double narrow<double>(double v) { return v; }
+template <> inline float narrow<float>(double v) { return (float)v; }
+template <> inline bfloat16 narrow<bfloat16>(double v) { return toBfloat16((float)v); }
+
+// dot(a, x) with a in low precision, x and the sum in double
+template <typename T>
+using MixedRowDotFn = double (*)(const T* a, const double* x, int n);
+
+template <typename T>
+inline double rowDotMixedScalar(const T* a, const double* x, int n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        s0 += widen(a[j]) * x[j];
+        s1 += widen(a[j + 1]) * x[j + 1];
+        s2 += widen(a[j + 2]) * x[j + 2];
+        s3 += widen(a[j + 3]) * x[j + 3];
+    }
+    for (; j < n; j++) {
+        s0 += widen(a[j]) * x[j];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+// 8 low-precision values widened to floats (also used by the AVX-512 kernel)
+__attribute__((target("avx2,fma")))
+inline __m256 loadWidenAvx2(const float* a) { return _mm256_loadu_ps(a); }
+
+__attribute__((target("avx2,fma")))
+inline __m256 loadWidenAvx2(const bfloat16* a) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+}
+
+template <typename T>
+__attribute__((target("avx2,fma")))
+inline double rowDotMixedAvx2(const T* a, const double* x, int n) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd();
+    __m256d acc3 = _mm256_setzero_pd();
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        __m256 f0 = loadWidenAvx2(a + j);
+        __m256 f1 = loadWidenAvx2(a + j + 8);
+        acc0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(f0)), _mm256_loadu_pd(x + j), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(f0, 1)), _mm256_loadu_pd(x + j + 4), acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(f1)), _mm256_loadu_pd(x + j + 8), acc2);
+        acc3 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(f1, 1)), _mm256_loadu_pd(x + j + 12), acc3);
+    }
+    __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    __m128d lo = _mm256_castpd256_pd128(acc);
+    __m128d hi = _mm256_extractf128_pd(acc, 1);
+    lo = _mm_add_pd(lo, hi);
+    double sum = _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    for (; j < n; j++) {
+        sum += widen(a[j]) * x[j];
+    }
+    return sum;
+}
+
+// 8 floats to 8 doubles. The zero-masked form is used because GCC 12 warns
+// about the undefined source operand of the plain _mm512_cvtps_pd.
+__attribute__((target("avx512f")))
+inline __m512d widenAvx512(__m256 f) { return _mm512_maskz_cvtps_pd((__mmask8)0xff, f); }
+
+template <typename T>
+__attribute__((target("avx512f")))
+inline double rowDotMixedAvx512(const T* a, const double* x, int n) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd();
+    __m512d acc3 = _mm512_setzero_pd();
+    int j = 0;
+    for (; j + 32 <= n; j += 32) {
+        acc0 = _mm512_fmadd_pd(widenAvx512(loadWidenAvx2(a + j)), _mm512_loadu_pd(x + j), acc0);
+        acc1 = _mm512_fmadd_pd(widenAvx512(loadWidenAvx2(a + j + 8)), _mm512_loadu_pd(x + j + 8), acc1);
+        acc2 = _mm512_fmadd_pd(widenAvx512(loadWidenAvx2(a + j + 16)), _mm512_loadu_pd(x + j + 16), acc2);
+        acc3 = _mm512_fmadd_pd(widenAvx512(loadWidenAvx2(a + j + 24)), _mm512_loadu_pd(x + j + 24), acc3);
+    }
+    for (; j + 8 <= n; j += 8) {
+        acc0 = _mm512_fmadd_pd(widenAvx512(loadWidenAvx2(a + j)), _mm512_loadu_pd(x + j), acc0);
+    }
+    __m512d acc = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, acc);
+    double sum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+                 ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    for (; j < n; j++) {
+        sum += widen(a[j]) * x[j];
+    }
+    return sum;
+}
+#endif
+
+// Best mixed kernel for the running CPU (same order as activeRowDotKernel)
+template <typename T>
+inline MixedRowDotFn<T> activeMixedRowDot() {
+#ifdef JACOBI_HAVE_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return rowDotMixedAvx512<T>;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return rowDotMixedAvx2<T>;
+    }
+#endif
+    return rowDotMixedScalar<T>;
+}
+
+// A stored in T plus its diagonal in double
+template <typename T>
+struct MixedPrecisionMatrix {
+    BasicDenseMatrix<T> A;
+    std::vector<double> diag;
+};
+
+// Round A to T (parallel, same static row partition as the solver)
+template <typename T>
+inline MixedPrecisionMatrix<T> convertPrecision(const DenseMatrix& A, int numThreads) {
+    int n = A.rows();
+    MixedPrecisionMatrix<T> M{BasicDenseMatrix<T>(n, A.cols(), numThreads), std::vector<double>(n)};
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
+    for (int i = 0; i < n; i++) {
+        const double* src = A.rowPtr(i);
+        T* dst = M.A.rowPtr(i);
+        for (int j = 0; j < A.cols(); j++) {
+            dst[j] = narrow<T>(src[j]);
+        }
+        M.diag[i] = src[i];
+    }
+    return M;
+}
+
+// Jacobi on the mixed-precision matrix; same interface as jacobiParallel.
+// The diagonal term removed from the dot product is the stored (rounded)
+// one; the division uses the exact double diagonal.
+template <typename T>
+inline int jacobiParallelMixed(const MixedPrecisionMatrix<T>& M, const std::vector<double>& b,
+                               std::vector<double>& x, int n, double tolerance,
+                               int maxIterations, int numThreads) {
+    std::vector<double> x_new(n, 0.0);
+    MixedRowDotFn<T> dot = activeMixedRowDot<T>();
+    ThreadReducer maxDiffReducer(numThreads);
+    int iterations = 0;
+
+    omp_set_num_threads(numThreads);
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+        const double* xCur = x.data();
+        double* xNext = x_new.data();
+        maxDiffReducer.reset(0.0);
+
+        #pragma omp parallel
+        {
+            double localMax = 0.0;
+
+            #pragma omp for schedule(static) nowait
+            for (int i = 0; i < n; i++) {
+                const T* Ai = M.A.rowPtr(i);
+                double sigma = dot(Ai, xCur, n) - widen(Ai[i]) * xCur[i];
+                xNext[i] = (b[i] - sigma) / M.diag[i];
+                localMax = std::max(localMax, std::fabs(xNext[i] - xCur[i]));
+            }
+
+            maxDiffReducer.publishMax(localMax);
+        }
+
+        x.swap(x_new);
+        iterations++;
+
+        if (maxDiffReducer.max() < tolerance) {
+            break;
+        }
+    }
+
+    return iterations;
+}
+
+// r = b - A x in double; returns ||r||_2 (the value computeResidual reports)
+inline double residualVector(const DenseMatrix& A, const std::vector<double>& b,
+                             const std::vector<double>& x, std::vector<double>& r,
+                             int n, int numThreads) {
+    RowDotFn dot = activeRowDotKernel().fn;
+    double norm2 = 0.0;
+    #pragma omp parallel for schedule(static) num_threads(numThreads) reduction(+:norm2)
+    for (int i = 0; i < n; i++) {
+        r[i] = b[i] - dot(A.rowPtr(i), x.data(), n);
+        norm2 += r[i] * r[i];
+    }
+    return std::sqrt(norm2);
+}
+
+struct RefinementStats {
+    int sweeps = 0;      // mixed-precision sweeps over all solves
+    int refinements = 0; // correction solves after the initial one
+};
+
+// Mixed-precision solve followed by iterative refinement against the double
+// matrix A, until the correction is below `tolerance` (or maxRefinements)
+template <typename T>
+inline int jacobiMixedRefined(const DenseMatrix& A, const MixedPrecisionMatrix<T>& M,
+                              const std::vector<double>& b, std::vector<double>& x, int n,
+                              double tolerance, int maxIterations, int numThreads,
+                              RefinementStats* stats = nullptr, int maxRefinements = 10) {
+    RefinementStats st;
+    st.sweeps = jacobiParallelMixed(M, b, x, n, tolerance, maxIterations, numThreads);
+
+    std::vector<double> r(n), d(n);
+    for (int k = 0; k < maxRefinements && st.sweeps < maxIterations; k++) {
+        residualVector(A, b, x, r, n, numThreads);
+        std::fill(d.begin(), d.end(), 0.0);
+        st.sweeps += jacobiParallelMixed(M, r, d, n, tolerance, maxIterations - st.sweeps,
+                                         numThreads);
+        st.refinements++;
+
+        double maxCorrection = 0.0;
+        #pragma omp parallel for schedule(static) num_threads(numThreads) reduction(max:maxCorrection)
+        for (int i = 0; i < n; i++) {
+            x[i] += d[i];
+            maxCorrection = std::max(maxCorrection, std::fabs(d[i]));
+        }
+        if (maxCorrection < tolerance) {
+            break;
+        }
+    }
+
+    if (stats) {
+        *stats = st;
+    }
+    return st.sweeps;
+}
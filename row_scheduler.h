@@ -0,0 +1,211 @@
+/*
+ * Work-Stealing Row-Block Scheduler
+ * nnz-balanced row blocks with fixed owners and lock-free stealing
+ *
+ * schedule(static) gives every thread the same number of rows, which for
+ * rows of very different lengths means very different amounts of work.
+ * The scheduler instead cuts the rows into contiguous blocks of roughly
+ * equal cost (nonzeros plus a per-row term for the update) and gives each
+ * thread a contiguous run of blocksPerThread blocks. A thread works through
+ * its own blocks from the front; once they are gone it steals from the back
+ * of other threads' runs, so the blocks a thread loses are the ones furthest
+ * from the rows it is still working on.
+ *
+ * Ownership never changes: every sweep starts with each thread holding the
+ * same blocks, so a row block is touched by the same thread (same caches,
+ * same NUMA node after first touch) on every sweep unless it was stolen in
+ * that sweep.
+ *
+ * Each run is one 64-bit atomic word (head << 32 | tail); the owner takes
+ * the head and thieves take the tail, both by compare-and-swap. Runs are
+ * refilled between sweeps, outside the parallel region.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+
+#include "sparse_matrix.h"
+
+struct RowBlock {
+    int begin = 0;
+    int end = 0;
+};
+
+struct SchedulerStats {
+    long long blocksRun = 0; // over all sweeps
+    long long steals = 0;    // blocks run by a thread other than their owner
+};
+
+class WorkStealingScheduler {
+public:
+    // Cost of a row: its nonzeros plus rowCost for the update and diff
+    static constexpr int kRowCost = 2;
+
+    WorkStealingScheduler(const CsrMatrix& A, int numThreads, int blocksPerThread = 8,
+                          bool stealing = true)
+        : numThreads_(std::max(1, numThreads)),
+          blocksPerThread_(std::max(1, blocksPerThread)), stealing_(stealing),
+          runs_(numThreads_), stealCounts_(numThreads_) {
+        int numBlocks = numThreads_ * blocksPerThread_;
+        long long total = A.nnz() + (long long)kRowCost * A.n;
+        blocks_.resize(numBlocks);
+        int row = 0;
+        for (int k = 0; k < numBlocks; k++) {
+            long long target = total * (k + 1) / numBlocks;
+            int begin = row;
+            while (row < A.n && cost(A, row + 1) <= target) {
+                row++;
+            }
+            if (k == numBlocks - 1) {
+                row = A.n;
+            }
+            blocks_[k] = {begin, row};
+        }
+        reset();
+    }
+
+    int numThreads() const { return numThreads_; }
+    const std::vector<RowBlock>& blocks() const { return blocks_; }
+    const SchedulerStats& stats() const { return stats_; }
+
+    // Rows owned by thread t (its blocks are contiguous)
+    RowBlock ownedRows(int t) const {
+        return {blocks_[t * blocksPerThread_].begin, blocks_[(t + 1) * blocksPerThread_ - 1].end};
+    }
+
+    // Refill every run with its owner's blocks (call outside the region)
+    void reset() {
+        for (int t = 0; t < numThreads_; t++) {
+            uint64_t head = (uint64_t)t * blocksPerThread_;
+            runs_[t].word.store(head << 32 | (head + blocksPerThread_), std::memory_order_relaxed);
+        }
+    }
+
+    // Run body(block) for every block once: own blocks first, then stolen
+    // ones. Call from every thread of a parallel region of numThreads.
+    template <class Body>
+    void forEachBlock(Body&& body) {
+        const int t = omp_get_thread_num();
+        int block;
+        long long stolen = 0, run = 0;
+        while (popOwn(t, block)) {
+            body(blocks_[block]);
+            run++;
+        }
+        // Without stealing, a team smaller than numThreads still has to
+        // cover the blocks of the missing threads
+        if (stealing_ || omp_get_num_threads() < numThreads_) {
+            for (int k = 1; k < numThreads_; k++) {
+                int victim = (t + k) % numThreads_;
+                while (steal(victim, block)) {
+                    body(blocks_[block]);
+                    run++;
+                    stolen++;
+                }
+            }
+        }
+        stealCounts_[t].blocks += run;
+        stealCounts_[t].steals += stolen;
+    }
+
+    // Fold the per-thread counters into stats() (call outside the region)
+    void collectStats() {
+        for (Counter& c : stealCounts_) {
+            stats_.blocksRun += c.blocks;
+            stats_.steals += c.steals;
+            c = Counter();
+        }
+    }
+
+private:
+    static long long cost(const CsrMatrix& A, int rows) {
+        return A.rowPtr[rows] + (long long)kRowCost * rows;
+    }
+
+    bool popOwn(int t, int& block) {
+        uint64_t w = runs_[t].word.load(std::memory_order_relaxed);
+        while ((w >> 32) < (w & 0xffffffffu)) {
+            if (runs_[t].word.compare_exchange_weak(w, w + ((uint64_t)1 << 32),
+                                                    std::memory_order_acq_rel)) {
+                block = (int)(w >> 32);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool steal(int victim, int& block) {
+        uint64_t w = runs_[victim].word.load(std::memory_order_relaxed);
+        while ((w >> 32) < (w & 0xffffffffu)) {
+            if (runs_[victim].word.compare_exchange_weak(w, w - 1, std::memory_order_acq_rel)) {
+                block = (int)(w & 0xffffffffu) - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct alignas(64) Run {
+        std::atomic<uint64_t> word{0};
+    };
+    struct alignas(64) Counter {
+        long long blocks = 0;
+        long long steals = 0;
+    };
+
+    int numThreads_;
+    int blocksPerThread_;
+    bool stealing_;
+    std::vector<RowBlock> blocks_;
+    std::vector<Run> runs_;
+    std::vector<Counter> stealCounts_;
+    SchedulerStats stats_;
+};
+
+// Parallel Jacobi on CSR storage with the rows handed out by `scheduler`
+// (built for this matrix and numThreads); same interface and stopping rule
+// as the schedule(static) CSR solver
+inline int jacobiParallel(const CsrMatrix& A, const std::vector<double>& b,
+                          std::vector<double>& x, int n, double tolerance, int maxIterations,
+                          WorkStealingScheduler& scheduler) {
+    std::vector<double> x_new(n, 0.0);
+    const int numThreads = scheduler.numThreads();
+    int iterations = 0;
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+        double maxDiff = 0.0;
+        const double* xCur = x.data();
+        double* xNext = x_new.data();
+        scheduler.reset();
+
+        #pragma omp parallel num_threads(numThreads) reduction(max:maxDiff)
+        {
+            scheduler.forEachBlock([&](const RowBlock& rows) {
+                for (int i = rows.begin; i < rows.end; i++) {
+                    double sum = 0.0;
+                    for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; p++) {
+                        sum += A.values[p] * xCur[A.colIdx[p]];
+                    }
+                    double sigma = sum - A.diag[i] * xCur[i];
+                    xNext[i] = (b[i] - sigma) / A.diag[i];
+                    maxDiff = std::max(maxDiff, std::fabs(xNext[i] - xCur[i]));
+                }
+            });
+        }
+
+        x.swap(x_new);
+        iterations++;
+
+        if (maxDiff < tolerance) {
+            break;
+        }
+    }
+
+    scheduler.collectStats();
+    return iterations;
+}
@@ -0,0 +1,230 @@
+/*
+ * Scaling Model and Roofline
+ * Fits serial-fraction / bandwidth-saturation models to measured runs
+ *
+ * The time of a solve on P threads is modelled as
+ *   T(P) = max(T1 * (s + (1 - s) / P), T1 / Smax) + c * (P - 1)
+ * s     serial fraction (Amdahl)
+ * Smax  speedup at which the memory bandwidth saturates (inf = never)
+ * c     per-thread fork/join and synchronisation cost
+ * s and Smax are found by a grid search, c in closed form for each pair;
+ * the fit minimises the squared relative error of the predicted times.
+ * The c term makes the curve turn up again, so the model predicts a best
+ * thread count instead of always "as many as possible".
+ *
+ * The roofline bounds a kernel of operational intensity I (flop/byte) at
+ * min(peak GFLOP/s, I * STREAM GB/s); a dense Jacobi sweep does 2 flops
+ * per 8-byte matrix entry, I = 0.25.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <omp.h>
+
+#include "instrumentation.h"
+#include "jacobi_kernels.h"
+
+struct ScalingSample {
+    int threads = 1;
+    double timeMs = 0.0;
+};
+
+struct ScalingFit {
+    bool valid = false;     // needs at least two distinct thread counts
+    double t1Ms = 0.0;      // single-thread time the model is scaled from
+    double serialFraction = 0.0;
+    double maxSpeedup = std::numeric_limits<double>::infinity();
+    double overheadMs = 0.0; // per extra thread
+    double rmsError = 0.0;   // relative, over the samples
+
+    double predictMs(int threads) const {
+        double p = std::max(1, threads);
+        double amdahl = t1Ms * (serialFraction + (1.0 - serialFraction) / p);
+        return std::max(amdahl, t1Ms / maxSpeedup) + overheadMs * (p - 1.0);
+    }
+
+    double predictSpeedup(int threads) const { return t1Ms / predictMs(threads); }
+
+    // Thread count in [1, maxThreads] with the lowest predicted time
+    int bestThreads(int maxThreads) const {
+        int best = 1;
+        for (int p = 2; p <= maxThreads; p++) {
+            if (predictMs(p) < predictMs(best)) {
+                best = p;
+            }
+        }
+        return best;
+    }
+};
+
+// Fit the model to `samples`; t1Ms is T(1), measured or a sequential proxy
+inline ScalingFit fitScaling(const std::vector<ScalingSample>& samples, double t1Ms) {
+    ScalingFit fit;
+    fit.t1Ms = t1Ms;
+    int maxP = 1;
+    int distinct = 0;
+    for (size_t k = 0; k < samples.size(); k++) {
+        maxP = std::max(maxP, samples[k].threads);
+        bool seen = false;
+        for (size_t j = 0; j < k; j++) {
+            seen = seen || samples[j].threads == samples[k].threads;
+        }
+        distinct += !seen;
+    }
+    if (distinct < 2 || t1Ms <= 0.0) {
+        return fit;
+    }
+
+    // Saturation candidates: none, every observed speedup, a geometric grid
+    std::vector<double> saturation = {std::numeric_limits<double>::infinity()};
+    for (const ScalingSample& smp : samples) {
+        if (smp.timeMs > 0.0 && t1Ms / smp.timeMs > 1.0) {
+            saturation.push_back(t1Ms / smp.timeMs);
+        }
+    }
+    for (int k = 1; k <= 32; k++) {
+        saturation.push_back(std::pow((double)maxP, k / 32.0));
+    }
+
+    ScalingFit trial = fit;
+    double bestError = std::numeric_limits<double>::infinity();
+    for (int si = 0; si <= 200; si++) {
+        trial.serialFraction = si / 200.0;
+        for (double smax : saturation) {
+            trial.maxSpeedup = std::max(1.0, smax);
+            trial.overheadMs = 0.0;
+            // Relative-error least squares for c: minimise sum ((r - c u) / T)^2
+            double num = 0.0, den = 0.0;
+            for (const ScalingSample& smp : samples) {
+                double u = smp.threads - 1.0;
+                double w = 1.0 / (smp.timeMs * smp.timeMs);
+                num += w * u * (smp.timeMs - trial.predictMs(smp.threads));
+                den += w * u * u;
+            }
+            trial.overheadMs = den > 0.0 ? std::max(0.0, num / den) : 0.0;
+            double error = 0.0;
+            for (const ScalingSample& smp : samples) {
+                double rel = (trial.predictMs(smp.threads) - smp.timeMs) / smp.timeMs;
+                error += rel * rel;
+            }
+            if (error < bestError) {
+                bestError = error;
+                fit = trial;
+            }
+        }
+    }
+    fit.valid = true;
+    fit.rmsError = std::sqrt(bestError / samples.size());
+    return fit;
+}
+
+struct RooflineMachine {
+    double peakGflops = 0.0; // double-precision FMA throughput of all threads
+    double streamGBs = 0.0;  // STREAM triad
+
+    double attainableGflops(double intensity) const {
+        return std::min(peakGflops, intensity * streamGBs);
+    }
+    double ridgeIntensity() const { return streamGBs > 0.0 ? peakGflops / streamGBs : 0.0; }
+};
+
+// Flops per byte of one dense Jacobi sweep: 2 flops per 8-byte entry of A
+constexpr double kDenseSweepIntensity = 0.25;
+
+// FMA throughput kernels: `rounds` x (independent accumulators x lanes)
+// FMAs, enough accumulators to cover the FMA latency; return a checksum
+inline double fmaLoopScalar(long long rounds) {
+    double acc[8] = {1.0, 1.1, 1.2, 1.3, 1.4, 1.5, 1.6, 1.7};
+    const double a = 0.999999, c = 1.0e-7;
+    for (long long r = 0; r < rounds; r++) {
+#pragma GCC unroll 8
+        for (int k = 0; k < 8; k++) {
+            acc[k] = acc[k] * a + c;
+        }
+    }
+    return acc[0] + acc[1] + acc[2] + acc[3] + acc[4] + acc[5] + acc[6] + acc[7];
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+__attribute__((target("avx2,fma")))
+inline double fmaLoopAvx2(long long rounds) {
+    __m256d acc[12];
+    for (int k = 0; k < 12; k++) {
+        acc[k] = _mm256_set1_pd(1.0 + k * 1.0e-3);
+    }
+    const __m256d a = _mm256_set1_pd(0.999999), c = _mm256_set1_pd(1.0e-7);
+    for (long long r = 0; r < rounds; r++) {
+#pragma GCC unroll 12
+        for (int k = 0; k < 12; k++) {
+            acc[k] = _mm256_fmadd_pd(acc[k], a, c);
+        }
+    }
+    alignas(32) double lanes[4];
+    double sum = 0.0;
+    for (int k = 0; k < 12; k++) {
+        _mm256_store_pd(lanes, acc[k]);
+        sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+inline double fmaLoopAvx512(long long rounds) {
+    __m512d acc[16];
+    for (int k = 0; k < 16; k++) {
+        acc[k] = _mm512_set1_pd(1.0 + k * 1.0e-3);
+    }
+    const __m512d a = _mm512_set1_pd(0.999999), c = _mm512_set1_pd(1.0e-7);
+    for (long long r = 0; r < rounds; r++) {
+#pragma GCC unroll 16
+        for (int k = 0; k < 16; k++) {
+            acc[k] = _mm512_fmadd_pd(acc[k], a, c);
+        }
+    }
+    alignas(64) double lanes[8];
+    double sum = 0.0;
+    for (int k = 0; k < 16; k++) {
+        _mm512_store_pd(lanes, acc[k]);
+        sum += ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+               ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+    return sum;
+}
+#endif
+
+// Double-precision FMA peak of numThreads threads with the widest SIMD
+// the CPU supports (the same dispatch as the row kernels)
+inline double measurePeakGflops(int numThreads, long long rounds = 1 << 22) {
+    double (*loop)(long long) = fmaLoopScalar;
+    double flopsPerRound = 2.0 * 8;
+#ifdef JACOBI_HAVE_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        loop = fmaLoopAvx512;
+        flopsPerRound = 2.0 * 16 * 8;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        loop = fmaLoopAvx2;
+        flopsPerRound = 2.0 * 12 * 4;
+    }
+#endif
+    double sink = 0.0;
+    double start = omp_get_wtime();
+    #pragma omp parallel num_threads(numThreads) reduction(+:sink)
+    {
+        sink += loop(rounds);
+    }
+    double elapsed = omp_get_wtime() - start;
+    double flops = flopsPerRound * (double)rounds * numThreads;
+    return sink > 0.0 ? flops / (elapsed * 1.0e9) : 0.0;
+}
+
+inline RooflineMachine measureRoofline(int numThreads) {
+    RooflineMachine m;
+    m.peakGflops = measurePeakGflops(numThreads);
+    m.streamGBs = measureStreamTriad(numThreads);
+    return m;
+}
@@ -0,0 +1,226 @@
+/*
+ * Small-System Jacobi
+ * Compile-time-n kernels with fully unrolled row dot products
+ *
+ * For n <= 64 the generic solvers spend their time on loop control, the
+ * remainder handling of the row dot and the indirect kernel call rather
+ * than on flops. jacobiSmallFixed<N> knows n and the row stride at compile
+ * time:
+ *   - the row dot is one expanded sequence of SIMD multiply-adds (an index
+ *     pack over the vector chunks of the row), with no loop or remainder
+ *   - both iterates live on the stack, padded with zeros to the row stride
+ *     like the rows of A, so the last chunk is a plain full-width load
+ *   - one call runs a whole sweep, so there is no per-row indirect call
+ * The chunks go to the accumulators as in the AVX2 / scalar row kernel (the
+ * AVX2 tail aside), so the iterates match the generic solvers up to
+ * rounding.
+ *
+ * jacobiSmall() uses the specialisation for the common sizes in
+ * kSmallJacobiSizes and jacobiSmallGeneric (the same sweep with a runtime n
+ * and the matching row kernel) otherwise. The instruction set is picked once
+ * at startup, as for the row kernels.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+
+// Sizes with a compiled specialisation
+constexpr int kSmallJacobiSizes[] = {2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 40, 48, 56, 64};
+constexpr size_t kSmallJacobiCount = sizeof(kSmallJacobiSizes) / sizeof(kSmallJacobiSizes[0]);
+// Below this n a single SIMD chunk plus its horizontal sum costs more than
+// the scalar multiply-adds
+constexpr int kSmallJacobiSimdMinN = 8;
+
+// Row stride of a DenseMatrix with N columns (padded to a cache line)
+template <int N>
+constexpr size_t smallJacobiStride() {
+    constexpr size_t perLine = DenseMatrix::kAlignment / sizeof(double);
+    return ((size_t)N + perLine - 1) / perLine * perLine;
+}
+
+// Unrolled row dots: sum_j a[j] * x[j] for j < N. `a` and `x` are 64-byte
+// aligned and zero-padded to smallJacobiStride<N>().
+template <int N, size_t... J>
+inline double fixedRowDotScalar(const double* a, const double* x, std::index_sequence<J...>) {
+    constexpr size_t kBlocked = (size_t)N / 4 * 4;
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    ((acc[J < kBlocked ? J % 4 : 0] += a[J] * x[J]), ...);
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+// Chunks of four; the tail chunk reads the zero padding
+template <int N, size_t... K>
+__attribute__((target("avx2,fma")))
+inline double fixedRowDotAvx2(const double* a, const double* x, std::index_sequence<K...>) {
+    constexpr size_t kBlocked = (size_t)N / 16 * 4;
+    __m256d acc[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(),
+                      _mm256_setzero_pd()};
+    ((acc[K < kBlocked ? K % 4 : 0] =
+          _mm256_fmadd_pd(_mm256_load_pd(a + 4 * K), _mm256_load_pd(x + 4 * K),
+                          acc[K < kBlocked ? K % 4 : 0])),
+     ...);
+    __m256d sum = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+    __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+#endif
+
+// One sweep over all N rows (next = update of cur), returns the max diff
+template <int N>
+inline double smallSweepScalar(const double* a, const double* b, const double* cur,
+                               double* next) {
+    double maxDiff = 0.0;
+    for (int i = 0; i < N; i++) {
+        const double* Ai = a + i * smallJacobiStride<N>();
+        double sigma = fixedRowDotScalar<N>(Ai, cur, std::make_index_sequence<N>()) -
+                       Ai[i] * cur[i];
+        next[i] = (b[i] - sigma) / Ai[i];
+        maxDiff = std::max(maxDiff, std::fabs(next[i] - cur[i]));
+    }
+    return maxDiff;
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+template <int N>
+__attribute__((target("avx2,fma")))
+inline double smallSweepAvx2(const double* a, const double* b, const double* cur, double* next) {
+    double maxDiff = 0.0;
+    for (int i = 0; i < N; i++) {
+        const double* Ai = a + i * smallJacobiStride<N>();
+        double sigma = fixedRowDotAvx2<N>(Ai, cur, std::make_index_sequence<(N + 3) / 4>()) -
+                       Ai[i] * cur[i];
+        next[i] = (b[i] - sigma) / Ai[i];
+        maxDiff = std::max(maxDiff, std::fabs(next[i] - cur[i]));
+    }
+    return maxDiff;
+}
+#endif
+
+typedef double (*SmallSweepFn)(const double* a, const double* b, const double* cur, double* next);
+
+// Jacobi for a compile-time n with the given sweep; A must be an n x n
+// DenseMatrix (padded stride). Same interface and stopping rule as
+// jacobiSequential.
+template <int N, SmallSweepFn Sweep>
+int jacobiSmallFixed(const DenseMatrix& A, const std::vector<double>& b,
+                     std::vector<double>& x, double tolerance, int maxIterations) {
+    constexpr size_t kStride = smallJacobiStride<N>();
+    alignas(64) double bufA[kStride] = {};
+    alignas(64) double bufB[kStride] = {};
+    double* cur = bufA;
+    double* next = bufB;
+    std::copy(x.begin(), x.begin() + N, cur);
+    int iterations = 0;
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+        double maxDiff = Sweep(A.data(), b.data(), cur, next);
+        std::swap(cur, next);
+        iterations++;
+        if (maxDiff < tolerance) {
+            break;
+        }
+    }
+
+    std::copy(cur, cur + N, x.begin());
+    return iterations;
+}
+
+// Runtime-n fallback: the same sweep through a row kernel
+inline int jacobiSmallGeneric(const DenseMatrix& A, const std::vector<double>& b,
+                              std::vector<double>& x, int n, double tolerance,
+                              int maxIterations, RowDotFn dot) {
+    std::vector<double> x_new(n, 0.0);
+    int iterations = 0;
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+        double maxDiff = 0.0;
+        for (int i = 0; i < n; i++) {
+            x_new[i] = jacobiRowUpdate(dot, A.rowPtr(i), x.data(), b[i], i, n);
+            maxDiff = std::max(maxDiff, std::fabs(x_new[i] - x[i]));
+        }
+        x.swap(x_new);
+        iterations++;
+        if (maxDiff < tolerance) {
+            break;
+        }
+    }
+    return iterations;
+}
+
+typedef int (*SmallJacobiFn)(const DenseMatrix& A, const std::vector<double>& b,
+                             std::vector<double>& x, double tolerance, int maxIterations);
+
+// Specialisations of one instruction set and its generic row kernel
+struct SmallJacobiKernels {
+    const char* name;
+    RowDotFn dot;
+    std::array<SmallJacobiFn, kSmallJacobiCount> fixed;
+};
+
+template <size_t... K>
+SmallJacobiKernels smallJacobiScalar(std::index_sequence<K...>) {
+    return {"scalar", rowDotScalar,
+            {{&jacobiSmallFixed<kSmallJacobiSizes[K], smallSweepScalar<kSmallJacobiSizes[K]>>...}}};
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+template <int N>
+constexpr SmallJacobiFn smallJacobiAvx2Entry() {
+    return N < kSmallJacobiSimdMinN ? &jacobiSmallFixed<N, smallSweepScalar<N>>
+                                    : &jacobiSmallFixed<N, smallSweepAvx2<N>>;
+}
+
+template <size_t... K>
+SmallJacobiKernels smallJacobiAvx2(std::index_sequence<K...>) {
+    return {"avx2", rowDotAvx2, {{smallJacobiAvx2Entry<kSmallJacobiSizes[K]>()...}}};
+}
+#endif
+
+// Kernels picked once at startup: AVX2 where the CPU has it. AVX-512 is not
+// used here; for rows of at most eight zmm chunks its horizontal sum costs
+// as much as the chunks and the AVX2 kernels are faster at every size.
+inline const SmallJacobiKernels& activeSmallJacobiKernels() {
+    static const SmallJacobiKernels kernels = [] {
+        auto sizes = std::make_index_sequence<kSmallJacobiCount>();
+#ifdef JACOBI_HAVE_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return smallJacobiAvx2(sizes);
+        }
+#endif
+        return smallJacobiScalar(sizes);
+    }();
+    return kernels;
+}
+
+// Specialisation for n, or nullptr if n has none
+inline SmallJacobiFn findSmallJacobi(int n) {
+    for (size_t k = 0; k < kSmallJacobiCount; k++) {
+        if (kSmallJacobiSizes[k] == n) {
+            return activeSmallJacobiKernels().fixed[k];
+        }
+    }
+    return nullptr;
+}
+
+// Sequential Jacobi for small systems: the compile-time kernel when n has
+// one, the generic sweep with the matching row kernel otherwise
+inline int jacobiSmall(const DenseMatrix& A, const std::vector<double>& b,
+                       std::vector<double>& x, int n, double tolerance, int maxIterations) {
+    SmallJacobiFn fn = findSmallJacobi(n);
+    if (fn && A.rows() == n && A.cols() == n) {
+        return fn(A, b, x, tolerance, maxIterations);
+    }
+    return jacobiSmallGeneric(A, b, x, n, tolerance, maxIterations,
+                              activeSmallJacobiKernels().dot);
+}
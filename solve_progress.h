@@ -0,0 +1,373 @@
+/*
+ * Solve Progress and Checkpointing
+ * Throttled progress observer, asynchronous checkpoints of x, restart
+ *
+ * A solver given a SolveObserver hands it (sweep, diff, latest x) after the
+ * sweeps that measured the diff, from one thread and outside the row loop.
+ * The observer costs one clock read per such sweep; everything else is
+ * throttled by wall time:
+ *   - the progress callback runs at most every reportInterval seconds (and
+ *     once more when the solve ends)
+ *   - a checkpoint is offered to the AsyncCheckpointer at most every
+ *     checkpointInterval seconds
+ * Offering a checkpoint copies x into the checkpointer's staging buffer
+ * (O(n) against the O(nnz) sweep) and wakes its writer thread, which
+ * writes the file while the solve keeps sweeping. If the previous write is
+ * still running the offer is skipped rather than waited for, so a slow
+ * disk only makes checkpoints sparser and never stalls a sweep.
+ *
+ * Checkpoint file (native endianness):
+ *   CheckpointHeader (64 bytes), then n doubles of x
+ * It is written to "<path>.tmp" and renamed over <path>, so a crash
+ * mid-write leaves the previous checkpoint intact. The header carries the
+ * sweep count, the diff at that sweep, a fingerprint of the system (of b,
+ * by default) and a checksum of x; loadCheckpoint() rejects a file whose
+ * size, checksum or fingerprint does not match.
+ *
+ * Restart: load the checkpoint into x, tell the observer the sweeps already
+ * done (so reports and later checkpoints count from there) and give the
+ * solver the remaining budget, maxIterations - checkpoint.iteration.
+ */
+
+#pragma once
+
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+struct CheckpointHeader {
+    char magic[8];         // "JACOBICK"
+    uint32_t version;      // kCheckpointVersion
+    uint32_t endianTag;    // 0x01020304 as written by the producing machine
+    uint64_t n;
+    uint64_t iteration;    // sweeps done when x was taken
+    double diff;           // convergence measure at that sweep
+    uint64_t fingerprint;  // of the system being solved (0 = not checked)
+    uint64_t checksum;     // of the n doubles of x
+    uint8_t padding[8];
+};
+static_assert(sizeof(CheckpointHeader) == 64, "checkpoint header layout");
+
+constexpr char kCheckpointMagic[8] = {'J', 'A', 'C', 'O', 'B', 'I', 'C', 'K'};
+constexpr uint32_t kCheckpointVersion = 1;
+constexpr uint32_t kCheckpointEndianTag = 0x01020304u;
+
+// FNV-1a over raw bytes; used for the x checksum and the system fingerprint
+inline uint64_t checkpointHash(const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = 14695981039346656037ull;
+    for (size_t k = 0; k < bytes; k++) {
+        h = (h ^ p[k]) * 1099511628211ull;
+    }
+    return h | 1; // never 0, which means "unchecked"
+}
+
+// Fingerprint of a system from its right-hand side
+inline uint64_t systemFingerprint(const double* b, int n) {
+    return checkpointHash(b, (size_t)n * sizeof(double));
+}
+
+struct Checkpoint {
+    int iteration = 0;
+    double diff = 0.0;
+    uint64_t fingerprint = 0;
+    std::vector<double> x;
+};
+
+// Write x atomically (temporary file, then rename over `path`)
+inline bool saveCheckpoint(const std::string& path, const double* x, int n, int iteration,
+                           double diff, uint64_t fingerprint, std::string& error) {
+    CheckpointHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kCheckpointMagic, sizeof(h.magic));
+    h.version = kCheckpointVersion;
+    h.endianTag = kCheckpointEndianTag;
+    h.n = (uint64_t)n;
+    h.iteration = (uint64_t)iteration;
+    h.diff = diff;
+    h.fingerprint = fingerprint;
+    h.checksum = checkpointHash(x, (size_t)n * sizeof(double));
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(x), (std::streamsize)(n * sizeof(double)));
+        if (!out) {
+            error = "cannot write " + tmp;
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        error = "cannot rename " + tmp + " to " + path;
+        return false;
+    }
+    return true;
+}
+
+// Read a checkpoint; with a non-zero `fingerprint` the file must have been
+// written for the same system
+inline bool loadCheckpoint(const std::string& path, Checkpoint& out, std::string& error,
+                           uint64_t fingerprint = 0) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    const uint64_t size = (uint64_t)in.tellg();
+    in.seekg(0);
+    CheckpointHeader h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+        error = path + ": truncated header";
+        return false;
+    }
+    if (std::memcmp(h.magic, kCheckpointMagic, sizeof(h.magic)) != 0) {
+        error = path + ": not a checkpoint file";
+        return false;
+    }
+    if (h.version != kCheckpointVersion || h.endianTag != kCheckpointEndianTag) {
+        error = path + ": unsupported checkpoint version or byte order";
+        return false;
+    }
+    // Compared by division, so a corrupt n cannot wrap the size check
+    if (size < sizeof(h) || h.n > (uint64_t)INT_MAX ||
+        h.n != (size - sizeof(h)) / sizeof(double) || (size - sizeof(h)) % sizeof(double) != 0) {
+        error = path + ": file size does not match n = " + std::to_string(h.n);
+        return false;
+    }
+    if (h.iteration > (uint64_t)INT_MAX) {
+        error = path + ": sweep count " + std::to_string(h.iteration) + " out of range";
+        return false;
+    }
+    std::vector<double> x((size_t)h.n);
+    if (!in.read(reinterpret_cast<char*>(x.data()), (std::streamsize)(h.n * sizeof(double)))) {
+        error = path + ": truncated data";
+        return false;
+    }
+    if (checkpointHash(x.data(), x.size() * sizeof(double)) != h.checksum) {
+        error = path + ": checksum mismatch";
+        return false;
+    }
+    if (fingerprint != 0 && h.fingerprint != 0 && h.fingerprint != fingerprint) {
+        error = path + ": checkpoint belongs to a different system";
+        return false;
+    }
+    out.iteration = (int)h.iteration;
+    out.diff = h.diff;
+    out.fingerprint = h.fingerprint;
+    out.x.swap(x);
+    return true;
+}
+
+struct CheckpointStats {
+    int written = 0;  // files completed by the writer thread
+    int skipped = 0;  // offers dropped because a write was still running
+    int failed = 0;
+    std::string lastError;
+};
+
+// Background writer for checkpoints of one solve's x
+class AsyncCheckpointer {
+public:
+    AsyncCheckpointer(const std::string& path, uint64_t fingerprint = 0)
+        : path_(path), fingerprint_(fingerprint), writer_([this] { writerLoop(); }) {}
+
+    ~AsyncCheckpointer() {
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            idle_.wait(lock, [this] { return !pending_; });
+            quit_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+    }
+
+    AsyncCheckpointer(const AsyncCheckpointer&) = delete;
+    AsyncCheckpointer& operator=(const AsyncCheckpointer&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    // Stage x for writing; returns false (and counts a skip) if the writer
+    // is still busy with the previous checkpoint. Never blocks on the disk.
+    bool offer(const double* x, int n, int iteration, double diff) {
+        std::unique_lock<std::mutex> lock(lock_, std::try_to_lock);
+        if (!lock.owns_lock() || pending_) {
+            skipped_++;
+            return false;
+        }
+        staged_.assign(x, x + n);
+        stagedIteration_ = iteration;
+        stagedDiff_ = diff;
+        pending_ = true;
+        lock.unlock();
+        wake_.notify_one();
+        return true;
+    }
+
+    // Stage x even if that means waiting for the running write (end of solve)
+    void offerBlocking(const double* x, int n, int iteration, double diff) {
+        std::unique_lock<std::mutex> lock(lock_);
+        idle_.wait(lock, [this] { return !pending_; });
+        staged_.assign(x, x + n);
+        stagedIteration_ = iteration;
+        stagedDiff_ = diff;
+        pending_ = true;
+        lock.unlock();
+        wake_.notify_one();
+    }
+
+    // Wait until every staged checkpoint is on disk
+    void flush() {
+        std::unique_lock<std::mutex> lock(lock_);
+        idle_.wait(lock, [this] { return !pending_; });
+    }
+
+    CheckpointStats stats() {
+        std::lock_guard<std::mutex> lock(lock_);
+        CheckpointStats s = stats_;
+        s.skipped = skipped_;
+        return s;
+    }
+
+private:
+    // The staged buffer is swapped out under the lock and written without
+    // it, so offer() only ever waits for a buffer swap
+    void writerLoop() {
+        std::vector<double> buffer;
+        std::unique_lock<std::mutex> lock(lock_);
+        for (;;) {
+            wake_.wait(lock, [this] { return pending_ || quit_; });
+            if (!pending_) {
+                return;
+            }
+            buffer.swap(staged_);
+            int iteration = stagedIteration_;
+            double diff = stagedDiff_;
+            lock.unlock();
+
+            std::string error;
+            bool ok = saveCheckpoint(path_, buffer.data(), (int)buffer.size(), iteration, diff,
+                                     fingerprint_, error);
+
+            lock.lock();
+            if (ok) {
+                stats_.written++;
+            } else {
+                stats_.failed++;
+                stats_.lastError = error;
+            }
+            pending_ = false;
+            idle_.notify_all();
+        }
+    }
+
+    std::string path_;
+    uint64_t fingerprint_;
+    std::mutex lock_;
+    std::condition_variable wake_; // writer: a checkpoint is staged, or quit
+    std::condition_variable idle_; // offerers: the staged checkpoint is written
+    std::vector<double> staged_;
+    int stagedIteration_ = 0;
+    double stagedDiff_ = 0.0;
+    bool pending_ = false;
+    bool quit_ = false;
+    int skipped_ = 0; // only touched by the solve thread calling offer()
+    CheckpointStats stats_;
+    std::thread writer_; // last: started once the members above exist
+};
+
+struct SolveProgress {
+    int iteration = 0;          // sweeps done, counting those before a restart
+    double diff = 0.0;          // convergence measure at that sweep
+    double elapsedSeconds = 0.0; // since the observer was started
+    bool final = false;         // last report of the solve
+};
+
+typedef std::function<void(const SolveProgress&)> ProgressCallback;
+
+// Throttled progress reports and checkpoints for one solve at a time
+class SolveObserver {
+public:
+    explicit SolveObserver(ProgressCallback callback = ProgressCallback(),
+                           double reportInterval = 1.0)
+        : callback_(std::move(callback)), reportInterval_(reportInterval) {}
+
+    // Offer x to `checkpointer` at most every `interval` seconds
+    void setCheckpointer(AsyncCheckpointer* checkpointer, double interval) {
+        checkpointer_ = checkpointer;
+        checkpointInterval_ = interval;
+    }
+
+    // Sweeps already done by an earlier run this solve resumes
+    void setStartIteration(int iteration) { startIteration_ = iteration; }
+    int startIteration() const { return startIteration_; }
+
+    int reports() const { return reports_; }
+
+    // Called by the solver before its first sweep
+    void start() {
+        start_ = omp_get_wtime();
+        nextReport_ = start_ + reportInterval_;
+        nextCheckpoint_ = start_ + checkpointInterval_;
+        reports_ = 0;
+    }
+
+    // After sweep `sweep` (1-based, of this run) measured `diff`; x is the
+    // iterate after that sweep. Call from one thread, outside the row loop.
+    void observe(int sweep, double diff, const double* x, int n) {
+        double now = omp_get_wtime();
+        if (callback_ && now >= nextReport_) {
+            report(sweep, diff, now, false);
+            nextReport_ = now + reportInterval_;
+        }
+        if (checkpointer_ && now >= nextCheckpoint_) {
+            if (checkpointer_->offer(x, n, startIteration_ + sweep, diff)) {
+                nextCheckpoint_ = now + checkpointInterval_;
+            }
+        }
+    }
+
+    // After the last sweep: a final report, and a checkpoint of the final x
+    // (waiting for a running write if necessary) so a run that ran out of
+    // sweeps can be resumed exactly where it stopped
+    void finish(int sweeps, double diff, const double* x, int n) {
+        if (checkpointer_) {
+            checkpointer_->offerBlocking(x, n, startIteration_ + sweeps, diff);
+        }
+        if (callback_) {
+            report(sweeps, diff, omp_get_wtime(), true);
+        }
+    }
+
+private:
+    void report(int sweep, double diff, double now, bool final) {
+        SolveProgress p;
+        p.iteration = startIteration_ + sweep;
+        p.diff = diff;
+        p.elapsedSeconds = now - start_;
+        p.final = final;
+        callback_(p);
+        reports_++;
+    }
+
+    ProgressCallback callback_;
+    double reportInterval_;
+    AsyncCheckpointer* checkpointer_ = nullptr;
+    double checkpointInterval_ = 0.0;
+    int startIteration_ = 0;
+    double start_ = 0.0;
+    double nextReport_ = 0.0;
+    double nextCheckpoint_ = 0.0;
+    int reports_ = 0;
+};
@@ -0,0 +1,275 @@
+/*
+ * Sparse Matrix Storage
+ * CSR and SELL-C-sigma formats plus stencil and skewed system generators
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "counter_rng.h"
+#include "memory_arena.h"
+
+// Compressed Sparse Row: row i owns values[rowPtr[i] .. rowPtr[i+1])
+struct CsrMatrix {
+    int n = 0;
+    AlignedVector<int> rowPtr;
+    AlignedVector<int> colIdx;
+    AlignedVector<double> values;
+    AlignedVector<double> diag; // A[i][i], extracted once at build time
+
+    long long nnz() const { return (long long)values.size(); }
+
+    int rowLength(int i) const { return rowPtr[i + 1] - rowPtr[i]; }
+};
+
+// SELL-C-sigma (sliced ELLPACK).
+// Rows are sorted by length inside windows of sigma rows, then grouped into
+// chunks of C rows. Each chunk is padded to its longest row and stored column
+// by column, so entry k of lane r lives at chunkPtr[c] + k * C + r. The lanes
+// of one chunk map onto SIMD lanes. ELL is SELL with sigma = 1 and every
+// chunk padded to the longest row of the matrix.
+struct SellMatrix {
+    int n = 0;
+    int chunkSize = 0; // C
+    int sigma = 0;
+    AlignedVector<int> chunkPtr;   // offset of every chunk (numChunks + 1)
+    AlignedVector<int> chunkWidth; // padded row length of every chunk
+    AlignedVector<int> colIdx;
+    AlignedVector<double> values;
+    AlignedVector<int> rowOrder;   // storage lane -> original row (-1 for padding)
+    AlignedVector<double> diag;    // indexed by original row
+
+    int numChunks() const { return (int)chunkWidth.size(); }
+
+    long long storedEntries() const { return (long long)values.size(); }
+};
+
+// Build a SELL-C-sigma matrix from CSR; with uniformWidth every chunk is
+// padded to the longest row of the matrix instead of its own
+inline SellMatrix buildSell(const CsrMatrix& A, int chunkSize, int sigma,
+                            bool uniformWidth = false) {
+    SellMatrix S;
+    S.n = A.n;
+    S.chunkSize = chunkSize;
+    S.sigma = std::max(sigma, 1);
+    S.diag = A.diag;
+
+    int numChunks = (A.n + chunkSize - 1) / chunkSize;
+    S.rowOrder.assign((size_t)numChunks * chunkSize, -1);
+    std::iota(S.rowOrder.begin(), S.rowOrder.begin() + A.n, 0);
+
+    // Sort by descending row length inside each sigma window
+    for (int start = 0; start < A.n; start += S.sigma) {
+        int stop = std::min(start + S.sigma, A.n);
+        std::stable_sort(S.rowOrder.begin() + start, S.rowOrder.begin() + stop,
+                         [&A](int r1, int r2) { return A.rowLength(r1) > A.rowLength(r2); });
+    }
+
+    S.chunkPtr.assign(numChunks + 1, 0);
+    S.chunkWidth.assign(numChunks, 0);
+    for (int c = 0; c < numChunks; c++) {
+        int width = 0;
+        for (int r = 0; r < chunkSize; r++) {
+            int row = S.rowOrder[(size_t)c * chunkSize + r];
+            if (row >= 0) {
+                width = std::max(width, A.rowLength(row));
+            }
+        }
+        S.chunkWidth[c] = width;
+    }
+    if (uniformWidth && numChunks > 0) {
+        int width = *std::max_element(S.chunkWidth.begin(), S.chunkWidth.end());
+        std::fill(S.chunkWidth.begin(), S.chunkWidth.end(), width);
+    }
+    for (int c = 0; c < numChunks; c++) {
+        S.chunkPtr[c + 1] = S.chunkPtr[c] + S.chunkWidth[c] * chunkSize;
+    }
+
+    // Padding entries point at column 0 with a zero coefficient
+    S.colIdx.assign(S.chunkPtr[numChunks], 0);
+    S.values.assign(S.chunkPtr[numChunks], 0.0);
+    for (int c = 0; c < numChunks; c++) {
+        for (int r = 0; r < chunkSize; r++) {
+            int row = S.rowOrder[(size_t)c * chunkSize + r];
+            if (row < 0) {
+                continue;
+            }
+            int k = 0;
+            for (int p = A.rowPtr[row]; p < A.rowPtr[row + 1]; p++, k++) {
+                size_t slot = (size_t)S.chunkPtr[c] + (size_t)k * chunkSize + r;
+                S.colIdx[slot] = A.colIdx[p];
+                S.values[slot] = A.values[p];
+            }
+        }
+    }
+    return S;
+}
+
+// ELLPACK: rows in their original order, all padded to the longest row. It
+// is stored as chunks of kEllChunkSize rows, so the SELL solver can hand the
+// chunks to different threads and the lane sums stay in L1.
+constexpr int kEllChunkSize = 8;
+
+inline SellMatrix buildEll(const CsrMatrix& A) {
+    return buildSell(A, kEllChunkSize, 1, true);
+}
+
+// Neighbours of grid point i in ascending column order; returns the count
+// and sets diagSlot to the position of i itself
+inline int stencilColumns(int i, int nx, int ny, int nz, int cols[7], int& diagSlot) {
+    int x = i % nx;
+    int y = (i / nx) % ny;
+    int z = i / (nx * ny);
+
+    int count = 0;
+    if (z > 0) cols[count++] = i - nx * ny;
+    if (y > 0) cols[count++] = i - nx;
+    if (x > 0) cols[count++] = i - 1;
+    diagSlot = count;
+    cols[count++] = i;
+    if (x < nx - 1) cols[count++] = i + 1;
+    if (y < ny - 1) cols[count++] = i + nx;
+    if (z < nz - 1) cols[count++] = i + nx * ny;
+    return count;
+}
+
+// Generate rows [rowBegin, rowEnd) of a diagonally dominant 5-point
+// (nz == 1) or 7-point stencil system on an nx * ny * nz grid. The result
+// holds only those rows (A.n = rowEnd - rowBegin) with global column indices.
+// Values come from the counter-based generator keyed by the global (i, j),
+// so every partition and thread count reproduces the rows of the full system.
+// Row lengths are counted first, then rows are filled in parallel.
+inline void initializeStencilRows(CsrMatrix& A, std::vector<double>& b, int nx, int ny,
+                                  int nz, int rowBegin, int rowEnd,
+                                  uint64_t seed = kSystemSeed) {
+    int localRows = rowEnd - rowBegin;
+    A.n = localRows;
+    A.rowPtr.assign(localRows + 1, 0);
+    A.diag.assign(localRows, 0.0);
+    b.assign(localRows, 0.0);
+
+    #pragma omp parallel for schedule(static)
+    for (int li = 0; li < localRows; li++) {
+        int cols[7];
+        int diagSlot;
+        A.rowPtr[li + 1] = stencilColumns(rowBegin + li, nx, ny, nz, cols, diagSlot);
+    }
+    std::partial_sum(A.rowPtr.begin(), A.rowPtr.end(), A.rowPtr.begin());
+    A.colIdx.assign(A.rowPtr[localRows], 0);
+    A.values.assign(A.rowPtr[localRows], 0.0);
+
+    CounterRng matrixRng(RngStream::Matrix, seed);
+    CounterRng rhsRng(RngStream::Rhs, seed);
+
+    #pragma omp parallel for schedule(static)
+    for (int li = 0; li < localRows; li++) {
+        int i = rowBegin + li;
+        int cols[7];
+        int diagSlot;
+        int count = stencilColumns(i, nx, ny, nz, cols, diagSlot);
+
+        int rowStart = A.rowPtr[li];
+        double rowSum = 0.0;
+        for (int k = 0; k < count; k++) {
+            double v = 0.0;
+            if (k != diagSlot) {
+                v = (double)matrixRng.uniformInt(i, cols[k], 10) / 10.0; // Small off-diagonal values
+                rowSum += fabs(v);
+            }
+            A.colIdx[rowStart + k] = cols[k];
+            A.values[rowStart + k] = v;
+        }
+        // Make diagonal element dominant
+        A.values[rowStart + diagSlot] = rowSum + (double)(matrixRng.uniformInt(i, i, 10) + 1);
+        A.diag[li] = A.values[rowStart + diagSlot];
+        b[li] = (double)rhsRng.uniformInt(i, 0, 100) / 10.0;
+    }
+}
+
+// Generate the full diagonally dominant 5-point (nz == 1) or 7-point stencil
+// system. Coefficients follow initializeSystem: small random off-diagonal
+// values and a diagonal that dominates the row sum.
+inline void initializeStencilSystem(CsrMatrix& A, std::vector<double>& b,
+                                    int nx, int ny, int nz, uint64_t seed = kSystemSeed) {
+    initializeStencilRows(A, b, nx, ny, nz, 0, nx * ny * nz, seed);
+}
+
+// Row length of the skewed system: a few long rows at the top that decay
+// to `minLength` (power 8 over the row index), plus up to 25% jitter
+inline int skewedRowLength(int i, int n, int maxLength, int minLength, const CounterRng& rng) {
+    double t = 1.0 - (double)i / n;
+    int length = minLength + (int)((maxLength - minLength) * std::pow(t, 8.0));
+    length += rng.uniformInt(i, n, (uint32_t)(length / 4 + 1));
+    return std::min(length, n);
+}
+
+// Generate a diagonally dominant n x n system whose row lengths range from
+// maxLength (first rows) down to minLength, as in matrices with hub nodes.
+// A static row partition gives the first thread most of the nonzeros.
+// Off-diagonal columns are spread evenly over the row, values and b follow
+// initializeStencilRows.
+inline void initializeSkewedSystem(CsrMatrix& A, std::vector<double>& b, int n, int maxLength,
+                                   int minLength = 5, uint64_t seed = kSystemSeed) {
+    CounterRng matrixRng(RngStream::Matrix, seed);
+    CounterRng rhsRng(RngStream::Rhs, seed);
+    A.n = n;
+    A.rowPtr.assign(n + 1, 0);
+    A.diag.assign(n, 0.0);
+    b.assign(n, 0.0);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) {
+        A.rowPtr[i + 1] = skewedRowLength(i, n, maxLength, minLength, matrixRng);
+    }
+    std::partial_sum(A.rowPtr.begin(), A.rowPtr.end(), A.rowPtr.begin());
+    A.colIdx.assign(A.rowPtr[n], 0);
+    A.values.assign(A.rowPtr[n], 0.0);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < n; i++) {
+        int rowStart = A.rowPtr[i];
+        int count = A.rowLength(i);
+        // Diagonal plus count - 1 columns i + k * step (mod n), sorted
+        int* cols = A.colIdx.data() + rowStart;
+        int step = std::max(1, n / count);
+        for (int k = 0; k < count; k++) {
+            cols[k] = (int)((i + (long long)k * step) % n);
+        }
+        std::sort(cols, cols + count);
+
+        double rowSum = 0.0;
+        for (int k = 0; k < count; k++) {
+            int j = cols[k];
+            if (j == i) {
+                continue;
+            }
+            double v = (double)matrixRng.uniformInt(i, j, 10) / 10.0;
+            A.values[rowStart + k] = v;
+            rowSum += fabs(v);
+        }
+        int diagSlot = (int)(std::lower_bound(cols, cols + count, i) - cols);
+        A.values[rowStart + diagSlot] = rowSum + (double)(matrixRng.uniformInt(i, i, 10) + 1);
+        A.diag[i] = A.values[rowStart + diagSlot];
+        b[i] = (double)rhsRng.uniformInt(i, 0, 100) / 10.0;
+    }
+}
+
+// Function to verify solution by computing residual ||Ax - b||
+inline double computeResidual(const CsrMatrix& A, const std::vector<double>& b,
+                              const std::vector<double>& x, int n) {
+    double residual = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:residual)
+    for (int i = 0; i < n; i++) {
+        double sum = 0.0;
+        for (int p = A.rowPtr[i]; p < A.rowPtr[i + 1]; p++) {
+            sum += A.values[p] * x[A.colIdx[p]];
+        }
+        residual += (sum - b[i]) * (sum - b[i]);
+    }
+    return std::sqrt(residual);
+}
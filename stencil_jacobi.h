@@ -0,0 +1,287 @@
+/*
+ * Matrix-Free Stencil Jacobi
+ * Jacobi for Poisson-type problems on regular 2D/3D grids without storing A
+ *
+ * The operator is A = diag * I - (sum of grid neighbours) with zero Dirichlet
+ * boundaries, diag = 2 * dims + shift (shift = 0 is the plain Poisson matrix).
+ * The stencil is applied on the fly, so each sweep only streams x and b.
+ *
+ * Cache blocking:
+ *   - spatial: the grid is cut into tiles of tileY (and tileZ) rows of full
+ *     x-lines; one tile of neighbouring planes stays in cache while it is swept
+ *   - temporal: each tile plus a halo of timeSteps cells is copied into a
+ *     thread-local buffer and advanced timeSteps sweeps in cache (overlapped
+ *     ghost-zone tiling); the halo is recomputed redundantly so tiles never
+ *     synchronise between the sweeps of one block
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+
+#include "counter_rng.h"
+
+struct StencilProblem {
+    int nx = 0;
+    int ny = 0;
+    int nz = 1; // nz == 1 selects the 2D 5-point stencil
+    double shift = 0.0;
+
+    bool is3D() const { return nz > 1; }
+    int n() const { return nx * ny * nz; }
+    double diag() const { return (is3D() ? 6.0 : 4.0) + shift; }
+    // neighbour adds + right-hand side add + multiply by 1/diag
+    double flopsPerPoint() const { return is3D() ? 8.0 : 6.0; }
+};
+
+struct StencilBlocking {
+    int tileY = 32;    // rows per tile (0 = whole grid)
+    int tileZ = 8;     // planes per tile in 3D (0 = whole grid)
+    int timeSteps = 1; // sweeps per tile visit (1 = spatial blocking only)
+};
+
+// Padded grid with a one-cell ghost layer holding the zero boundary values
+struct StencilLayout {
+    int px, py, pz;
+    size_t sy, sz;
+
+    explicit StencilLayout(const StencilProblem& P)
+        : px(P.nx + 2), py(P.ny + 2), pz(P.is3D() ? P.nz + 2 : 1),
+          sy((size_t)P.nx + 2), sz((size_t)(P.nx + 2) * (P.ny + 2)) {}
+
+    size_t size() const { return sz * pz; }
+    size_t index(int x, int y, int z) const { return (size_t)z * sz + (size_t)y * sy + x; }
+    int zFirst() const { return pz > 1 ? 1 : 0; }
+};
+
+// Copy an interior-only vector (n = nx*ny*nz) into the padded layout
+inline void stencilScatter(const StencilProblem& P, const StencilLayout& L,
+                           const std::vector<double>& interior, std::vector<double>& padded) {
+    #pragma omp parallel for schedule(static) collapse(2)
+    for (int z = 0; z < P.nz; z++) {
+        for (int y = 0; y < P.ny; y++) {
+            const double* src = interior.data() + ((size_t)z * P.ny + y) * P.nx;
+            std::copy(src, src + P.nx, padded.data() + L.index(1, y + 1, z + L.zFirst()));
+        }
+    }
+}
+
+inline void stencilGather(const StencilProblem& P, const StencilLayout& L,
+                          const std::vector<double>& padded, std::vector<double>& interior) {
+    #pragma omp parallel for schedule(static) collapse(2)
+    for (int z = 0; z < P.nz; z++) {
+        for (int y = 0; y < P.ny; y++) {
+            const double* src = padded.data() + L.index(1, y + 1, z + L.zFirst());
+            std::copy(src, src + P.nx, interior.data() + ((size_t)z * P.ny + y) * P.nx);
+        }
+    }
+}
+
+// Jacobi update of one x-line of len points starting at padded index p0.
+// Returns the largest |u_new - u| on the line.
+template <bool Is3D>
+inline double stencilLineSweep(const double* u, double* out, const double* f, size_t p0,
+                               int len, size_t sy, size_t sz, double invDiag) {
+    double maxDiff = 0.0;
+    #pragma omp simd reduction(max:maxDiff)
+    for (int k = 0; k < len; k++) {
+        size_t p = p0 + k;
+        double sum = u[p - 1] + u[p + 1] + u[p - sy] + u[p + sy];
+        if (Is3D) {
+            sum += u[p - sz] + u[p + sz];
+        }
+        double v = (f[p] + sum) * invDiag;
+        out[p] = v;
+        maxDiff = std::max(maxDiff, std::fabs(v - u[p]));
+    }
+    return maxDiff;
+}
+
+// Advance one tile [y0,y1) x [z0,z1) by `steps` sweeps inside thread-local
+// buffers and write the result to `next`. Returns max diff of the last sweep.
+template <bool Is3D>
+inline double stencilTemporalTile(const StencilLayout& L, const double* u, const double* f,
+                                  double* next, int y0, int y1, int z0, int z1, int steps,
+                                  double invDiag, std::vector<double>& bufA,
+                                  std::vector<double>& bufB, std::vector<double>& bufF) {
+    int ly0 = std::max(0, y0 - steps), ly1 = std::min(L.py, y1 + steps);
+    int lz0 = Is3D ? std::max(0, z0 - steps) : 0;
+    int lz1 = Is3D ? std::min(L.pz, z1 + steps) : 1;
+    size_t lsy = L.sy;
+    size_t lsz = lsy * (size_t)(ly1 - ly0);
+    size_t localSize = lsz * (size_t)(lz1 - lz0);
+    if (bufA.size() < localSize) {
+        bufA.resize(localSize);
+        bufB.resize(localSize);
+        bufF.resize(localSize);
+    }
+
+    for (int z = lz0; z < lz1; z++) {
+        for (int y = ly0; y < ly1; y++) {
+            size_t g = L.index(0, y, z);
+            size_t l = (size_t)(z - lz0) * lsz + (size_t)(y - ly0) * lsy;
+            std::copy(u + g, u + g + L.px, bufA.data() + l);
+            std::copy(u + g, u + g + L.px, bufB.data() + l);
+            std::copy(f + g, f + g + L.px, bufF.data() + l);
+        }
+    }
+
+    double* src = bufA.data();
+    double* dst = bufB.data();
+    double maxDiff = 0.0;
+    for (int s = 1; s <= steps; s++) {
+        // The valid region shrinks by one cell per sweep, except where the
+        // tile touches the physical boundary (ghost values never change)
+        int ya = (ly0 == 0) ? 1 : ly0 + s;
+        int yb = (ly1 == L.py) ? L.py - 1 : ly1 - s;
+        int za = Is3D ? ((lz0 == 0) ? 1 : lz0 + s) : 0;
+        int zb = Is3D ? ((lz1 == L.pz) ? L.pz - 1 : lz1 - s) : 1;
+        for (int z = za; z < zb; z++) {
+            for (int y = ya; y < yb; y++) {
+                size_t p0 = (size_t)(z - lz0) * lsz + (size_t)(y - ly0) * lsy + 1;
+                double d = stencilLineSweep<Is3D>(src, dst, bufF.data(), p0, L.px - 2,
+                                                  lsy, lsz, invDiag);
+                if (s == steps && y >= y0 && y < y1 && z >= z0 && z < z1) {
+                    maxDiff = std::max(maxDiff, d);
+                }
+            }
+        }
+        std::swap(src, dst);
+    }
+
+    for (int z = z0; z < z1; z++) {
+        for (int y = y0; y < y1; y++) {
+            size_t l = (size_t)(z - lz0) * lsz + (size_t)(y - ly0) * lsy + 1;
+            std::copy(src + l, src + l + L.px - 2, next + L.index(1, y, z));
+        }
+    }
+    return maxDiff;
+}
+
+template <bool Is3D>
+inline int jacobiStencilImpl(const StencilProblem& P, const std::vector<double>& b,
+                             std::vector<double>& x, double tolerance, int maxIterations,
+                             int numThreads, const StencilBlocking& blocking) {
+    StencilLayout L(P);
+    std::vector<double> f(L.size(), 0.0), u(L.size(), 0.0), next(L.size(), 0.0);
+    stencilScatter(P, L, b, f);
+    stencilScatter(P, L, x, u);
+
+    const double invDiag = 1.0 / P.diag();
+    const int T = std::max(1, blocking.timeSteps);
+    const int tileY = blocking.tileY > 0 ? std::min(blocking.tileY, P.ny) : P.ny;
+    const int tileZ = Is3D ? (blocking.tileZ > 0 ? std::min(blocking.tileZ, P.nz) : P.nz) : 1;
+    const int numTy = (P.ny + tileY - 1) / tileY;
+    const int numTz = Is3D ? (P.nz + tileZ - 1) / tileZ : 1;
+    const int zBase = L.zFirst();
+    const int zLimit = Is3D ? P.nz + 1 : 1;
+
+    omp_set_num_threads(numThreads);
+    std::vector<std::vector<double>> scratch(3 * (size_t)numThreads);
+
+    int iterations = 0;
+    while (iterations < maxIterations) {
+        int steps = std::min(T, maxIterations - iterations);
+        double maxDiff = 0.0;
+
+        #pragma omp parallel for collapse(2) schedule(static) reduction(max:maxDiff)
+        for (int tz = 0; tz < numTz; tz++) {
+            for (int ty = 0; ty < numTy; ty++) {
+                int y0 = 1 + ty * tileY, y1 = std::min(y0 + tileY, P.ny + 1);
+                int z0 = zBase + tz * tileZ, z1 = std::min(z0 + tileZ, zLimit);
+                if (steps == 1) {
+                    for (int z = z0; z < z1; z++) {
+                        for (int y = y0; y < y1; y++) {
+                            double d = stencilLineSweep<Is3D>(u.data(), next.data(), f.data(),
+                                                              L.index(1, y, z), P.nx,
+                                                              L.sy, L.sz, invDiag);
+                            maxDiff = std::max(maxDiff, d);
+                        }
+                    }
+                } else {
+                    size_t t = 3 * (size_t)omp_get_thread_num();
+                    double d = stencilTemporalTile<Is3D>(L, u.data(), f.data(), next.data(),
+                                                         y0, y1, z0, z1, steps, invDiag,
+                                                         scratch[t], scratch[t + 1],
+                                                         scratch[t + 2]);
+                    maxDiff = std::max(maxDiff, d);
+                }
+            }
+        }
+
+        u.swap(next);
+        iterations += steps;
+
+        if (maxDiff < tolerance) {
+            break;
+        }
+    }
+
+    stencilGather(P, L, u, x);
+    return iterations;
+}
+
+// Matrix-free Jacobi for the stencil operator; x and b hold the nx*ny*nz
+// interior unknowns in x-fastest order. With timeSteps > 1 convergence is
+// only checked at the end of each block, so up to timeSteps - 1 extra sweeps
+// may be performed.
+inline int jacobiStencil(const StencilProblem& P, const std::vector<double>& b,
+                         std::vector<double>& x, int n, double tolerance, int maxIterations,
+                         int numThreads, const StencilBlocking& blocking = StencilBlocking()) {
+    (void)n;
+    if (P.is3D()) {
+        return jacobiStencilImpl<true>(P, b, x, tolerance, maxIterations, numThreads, blocking);
+    }
+    return jacobiStencilImpl<false>(P, b, x, tolerance, maxIterations, numThreads, blocking);
+}
+
+// Right-hand side matching initializeSystem's distribution (same generator)
+inline void initializeStencilRhs(const StencilProblem& P, std::vector<double>& b,
+                                 uint64_t seed = kSystemSeed) {
+    CounterRng rhsRng(RngStream::Rhs, seed);
+    b.resize(P.n());
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < P.n(); i++) {
+        b[i] = (double)rhsRng.uniformInt(i, 0, 100) / 10.0;
+    }
+}
+
+// Function to verify solution by computing residual ||Ax - b||
+inline double computeResidual(const StencilProblem& P, const std::vector<double>& b,
+                              const std::vector<double>& x, int n) {
+    (void)n;
+    StencilLayout L(P);
+    std::vector<double> u(L.size(), 0.0);
+    stencilScatter(P, L, x, u);
+    const double diag = P.diag();
+    const bool is3D = P.is3D();
+
+    double residual = 0.0;
+    #pragma omp parallel for collapse(2) schedule(static) reduction(+:residual)
+    for (int z = 0; z < P.nz; z++) {
+        for (int y = 0; y < P.ny; y++) {
+            for (int xi = 0; xi < P.nx; xi++) {
+                size_t p = L.index(xi + 1, y + 1, z + L.zFirst());
+                double sum = u[p - 1] + u[p + 1] + u[p - L.sy] + u[p + L.sy];
+                if (is3D) {
+                    sum += u[p - L.sz] + u[p + L.sz];
+                }
+                double r = diag * u[p] - sum - b[((size_t)z * P.ny + y) * P.nx + xi];
+                residual += r * r;
+            }
+        }
+    }
+    return std::sqrt(residual);
+}
+
+// Compulsory memory traffic per useful flop: per point and sweep the solver
+// reads u and b and writes u_new (counted twice for write-allocate), and a
+// temporal block of T sweeps moves that data only once.
+inline double stencilBytesPerFlop(const StencilProblem& P, int timeSteps) {
+    double bytesPerPoint = 4.0 * sizeof(double) / std::max(1, timeSteps);
+    return bytesPerPoint / P.flopsPerPoint();
+}
@@ -0,0 +1,354 @@
+/*
+ * Batched Independent Systems
+ * Many small A_s x_s = b_s solved at once, interleaved across systems
+ *
+ * A SystemBatch holds `count` independent n x n systems in packs of
+ * kBatchLanes (8) systems. Inside a pack the systems are interleaved
+ * entry by entry:
+ *   A: [pack][i][j][lane]    b, x: [pack][i][lane]
+ * so entry (i, j) of the eight systems is one cache line / one 512-bit
+ * vector. A sweep over a pack is the ordinary row sweep done for eight
+ * systems in lockstep: every multiply-add is a vertical SIMD operation over
+ * the lanes, with no horizontal sums and no remainder loops however small
+ * n is. Four rows are processed together so that the eight accumulators
+ * cover the FMA latency and each x_j vector is loaded once for four rows.
+ *
+ * solveBatch() runs the whole batch in one parallel region: threads take
+ * packs dynamically, so there is no fork/join per system or per sweep.
+ * Every system has its own convergence test and retires on its own: the
+ * sweep in which its max |x_new - x| drops below the tolerance writes its
+ * solution and iteration count (the stopping rule of jacobiSequential). A
+ * pack is done when its last lane retires; retired lanes keep riding along
+ * in the SIMD sweep until then (reported as the lane utilisation). Lanes
+ * past the end of the batch hold A = I, b = 0 and count as retired.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+#include "memory_arena.h"
+
+constexpr int kBatchLanes = 8;
+
+class SystemBatch {
+public:
+    SystemBatch(int n, int count)
+        : n_(n), count_(count), numPacks_((count + kBatchLanes - 1) / kBatchLanes),
+          a_((size_t)numPacks_ * n * n * kBatchLanes, 0.0),
+          b_((size_t)numPacks_ * n * kBatchLanes, 0.0),
+          x_((size_t)numPacks_ * n * kBatchLanes, 0.0), iterations_(count, 0) {
+        // Padding lanes: A = I, b = 0 (converged from the start)
+        for (int s = count; s < numPacks_ * kBatchLanes; s++) {
+            for (int i = 0; i < n; i++) {
+                a(s, i, i) = 1.0;
+            }
+        }
+    }
+
+    int n() const { return n_; }
+    int count() const { return count_; }
+    int numPacks() const { return numPacks_; }
+
+    double& a(int s, int i, int j) { return a_[index(s, (size_t)n_ * n_, (size_t)i * n_ + j)]; }
+    double& b(int s, int i) { return b_[index(s, n_, i)]; }
+    double& x(int s, int i) { return x_[index(s, n_, i)]; }
+    double x(int s, int i) const { return x_[index(s, n_, i)]; }
+
+    // Interleaved blocks of pack p
+    const double* packA(int p) const { return a_.data() + (size_t)p * n_ * n_ * kBatchLanes; }
+    const double* packB(int p) const { return b_.data() + (size_t)p * n_ * kBatchLanes; }
+    double* packX(int p) { return x_.data() + (size_t)p * n_ * kBatchLanes; }
+
+    // Copy system s in (initial guess x = 0) / its solution out
+    void setSystem(int s, const DenseMatrix& A, const std::vector<double>& rhs) {
+        for (int i = 0; i < n_; i++) {
+            for (int j = 0; j < n_; j++) {
+                a(s, i, j) = A(i, j);
+            }
+            b(s, i) = rhs[i];
+            x(s, i) = 0.0;
+        }
+    }
+
+    void solution(int s, std::vector<double>& out) const {
+        out.resize(n_);
+        for (int i = 0; i < n_; i++) {
+            out[i] = x(s, i);
+        }
+    }
+
+    // Sweeps of system s in the last solveBatch
+    int iterations(int s) const { return iterations_[s]; }
+    std::vector<int>& iterations() { return iterations_; }
+
+private:
+    // Entry `entry` of system s in an array with perPack entries per system
+    static size_t index(int s, size_t perPack, size_t entry) {
+        return ((size_t)(s / kBatchLanes) * perPack + entry) * kBatchLanes + s % kBatchLanes;
+    }
+
+    int n_;
+    int count_;
+    int numPacks_;
+    AlignedVector<double> a_;
+    AlignedVector<double> b_;
+    AlignedVector<double> x_;
+    std::vector<int> iterations_;
+};
+
+// One sweep over a pack: xNext = update of x for every lane, and
+// diff[lane] = max_i |xNext_i - x_i|. All pointers are 64-byte aligned.
+typedef void (*PackSweepFn)(const double* A, const double* b, const double* x, double* xNext,
+                            double* diff, int n);
+
+struct PackSweepKernel {
+    const char* name;
+    PackSweepFn fn;
+};
+
+inline void packSweepScalar(const double* A, const double* b, const double* x, double* xNext,
+                            double* diff, int n) {
+    constexpr int L = kBatchLanes;
+    for (int l = 0; l < L; l++) {
+        diff[l] = 0.0;
+    }
+    for (int i = 0; i < n; i++) {
+        const double* Ai = A + (size_t)i * n * L;
+        double acc[L] = {};
+        for (int j = 0; j < n; j++) {
+            for (int l = 0; l < L; l++) {
+                acc[l] += Ai[j * L + l] * x[j * L + l];
+            }
+        }
+        for (int l = 0; l < L; l++) {
+            double aii = Ai[i * L + l];
+            double value = (b[i * L + l] - (acc[l] - aii * x[i * L + l])) / aii;
+            xNext[i * L + l] = value;
+            diff[l] = std::max(diff[l], std::fabs(value - x[i * L + l]));
+        }
+    }
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+// Update of row i from its accumulated dot; returns |x_new - x| per lane
+__attribute__((target("avx2,fma")))
+inline __m256d packUpdateAvx2(__m256d acc, const double* Ai, const double* b,
+                              const double* x, double* xNext, int i) {
+    constexpr int L = kBatchLanes;
+    __m256d aii = _mm256_load_pd(Ai + i * L);
+    __m256d xi = _mm256_load_pd(x + i * L);
+    __m256d sigma = _mm256_fnmadd_pd(aii, xi, acc);
+    __m256d value = _mm256_div_pd(_mm256_sub_pd(_mm256_load_pd(b + i * L), sigma), aii);
+    _mm256_store_pd(xNext + i * L, value);
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(value, xi));
+}
+
+// The eight lanes as two 256-bit halves; four rows at a time
+__attribute__((target("avx2,fma")))
+inline void packSweepAvx2(const double* A, const double* b, const double* x, double* xNext,
+                          double* diff, int n) {
+    constexpr int L = kBatchLanes;
+    const size_t rowStride = (size_t)n * L;
+    __m256d maxLo = _mm256_setzero_pd();
+    __m256d maxHi = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const double* A0 = A + i * rowStride;
+        __m256d lo[4], hi[4];
+#pragma GCC unroll 4
+        for (int r = 0; r < 4; r++) {
+            lo[r] = _mm256_setzero_pd();
+            hi[r] = _mm256_setzero_pd();
+        }
+        for (int j = 0; j < n; j++) {
+            __m256d xLo = _mm256_load_pd(x + j * L);
+            __m256d xHi = _mm256_load_pd(x + j * L + 4);
+#pragma GCC unroll 4
+        for (int r = 0; r < 4; r++) {
+                const double* Aij = A0 + r * rowStride + j * L;
+                lo[r] = _mm256_fmadd_pd(_mm256_load_pd(Aij), xLo, lo[r]);
+                hi[r] = _mm256_fmadd_pd(_mm256_load_pd(Aij + 4), xHi, hi[r]);
+            }
+        }
+#pragma GCC unroll 4
+        for (int r = 0; r < 4; r++) {
+            const double* Ai = A0 + r * rowStride;
+            maxLo = _mm256_max_pd(maxLo, packUpdateAvx2(lo[r], Ai, b, x, xNext, i + r));
+            maxHi = _mm256_max_pd(maxHi, packUpdateAvx2(hi[r], Ai + 4, b + 4, x + 4,
+                                                        xNext + 4, i + r));
+        }
+    }
+    for (; i < n; i++) {
+        const double* Ai = A + i * rowStride;
+        __m256d lo = _mm256_setzero_pd();
+        __m256d hi = _mm256_setzero_pd();
+        for (int j = 0; j < n; j++) {
+            lo = _mm256_fmadd_pd(_mm256_load_pd(Ai + j * L), _mm256_load_pd(x + j * L), lo);
+            hi = _mm256_fmadd_pd(_mm256_load_pd(Ai + j * L + 4), _mm256_load_pd(x + j * L + 4),
+                                 hi);
+        }
+        maxLo = _mm256_max_pd(maxLo, packUpdateAvx2(lo, Ai, b, x, xNext, i));
+        maxHi = _mm256_max_pd(maxHi, packUpdateAvx2(hi, Ai + 4, b + 4, x + 4, xNext + 4, i));
+    }
+    _mm256_store_pd(diff, maxLo);
+    _mm256_store_pd(diff + 4, maxHi);
+}
+
+// Lane-wise max; the unmasked _mm512_max_pd trips a GCC 12
+// -Wmaybe-uninitialized false positive inside its header
+__attribute__((target("avx512f")))
+inline __m512d packMaxAvx512(__m512d a, __m512d b) {
+    return _mm512_mask_max_pd(a, (__mmask8)0xff, a, b);
+}
+
+__attribute__((target("avx512f")))
+inline __m512d packUpdateAvx512(__m512d acc, const double* Ai, const double* b,
+                                const double* x, double* xNext, int i) {
+    constexpr int L = kBatchLanes;
+    __m512d aii = _mm512_load_pd(Ai + i * L);
+    __m512d xi = _mm512_load_pd(x + i * L);
+    __m512d sigma = _mm512_fnmadd_pd(aii, xi, acc);
+    __m512d value = _mm512_div_pd(_mm512_sub_pd(_mm512_load_pd(b + i * L), sigma), aii);
+    _mm512_store_pd(xNext + i * L, value);
+    __m512i magnitude = _mm512_and_epi64(_mm512_castpd_si512(_mm512_sub_pd(value, xi)),
+                                         _mm512_set1_epi64(0x7fffffffffffffffLL));
+    return _mm512_castsi512_pd(magnitude);
+}
+
+// One 512-bit vector per entry; four rows at a time
+__attribute__((target("avx512f")))
+inline void packSweepAvx512(const double* A, const double* b, const double* x, double* xNext,
+                            double* diff, int n) {
+    constexpr int L = kBatchLanes;
+    const size_t rowStride = (size_t)n * L;
+    __m512d maxDiff = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const double* A0 = A + i * rowStride;
+        __m512d acc[4];
+#pragma GCC unroll 4
+        for (int r = 0; r < 4; r++) {
+            acc[r] = _mm512_setzero_pd();
+        }
+        for (int j = 0; j < n; j++) {
+            __m512d xj = _mm512_load_pd(x + j * L);
+#pragma GCC unroll 4
+        for (int r = 0; r < 4; r++) {
+                acc[r] = _mm512_fmadd_pd(_mm512_load_pd(A0 + r * rowStride + j * L), xj, acc[r]);
+            }
+        }
+#pragma GCC unroll 4
+        for (int r = 0; r < 4; r++) {
+            maxDiff = packMaxAvx512(
+                maxDiff, packUpdateAvx512(acc[r], A0 + r * rowStride, b, x, xNext, i + r));
+        }
+    }
+    for (; i < n; i++) {
+        const double* Ai = A + i * rowStride;
+        __m512d acc = _mm512_setzero_pd();
+        for (int j = 0; j < n; j++) {
+            acc = _mm512_fmadd_pd(_mm512_load_pd(Ai + j * L), _mm512_load_pd(x + j * L), acc);
+        }
+        maxDiff = packMaxAvx512(maxDiff, packUpdateAvx512(acc, Ai, b, x, xNext, i));
+    }
+    _mm512_store_pd(diff, maxDiff);
+}
+#endif
+
+// Pack kernel chosen once at startup (widest SIMD the CPU supports)
+inline const PackSweepKernel& activePackSweep() {
+    static const PackSweepKernel kernel = [] {
+#ifdef JACOBI_HAVE_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return PackSweepKernel{"avx512", packSweepAvx512};
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return PackSweepKernel{"avx2", packSweepAvx2};
+        }
+#endif
+        return PackSweepKernel{"scalar", packSweepScalar};
+    }();
+    return kernel;
+}
+
+struct BatchSolveStats {
+    long long systemSweeps = 0; // sum of the systems' iteration counts
+    long long laneSweeps = 0;   // pack sweeps x kBatchLanes (work actually done)
+    int maxIterations = 0;      // slowest system
+
+    double utilisation() const {
+        return laneSweeps > 0 ? (double)systemSweeps / laneSweeps : 0.0;
+    }
+};
+
+// Solve every system of the batch from its current x; solutions are
+// written back to the batch and batch.iterations(s) set. Each system stops
+// like jacobiSequential (max diff < tolerance, or maxIterations sweeps).
+inline BatchSolveStats solveBatch(SystemBatch& batch, double tolerance, int maxIterations,
+                                  int numThreads) {
+    constexpr int L = kBatchLanes;
+    const int n = batch.n();
+    const int count = batch.count();
+    PackSweepFn sweep = activePackSweep().fn;
+    std::vector<int>& iterations = batch.iterations();
+    long long systemSweeps = 0, laneSweeps = 0;
+    int slowest = 0;
+
+    #pragma omp parallel num_threads(numThreads) \
+        reduction(+:systemSweeps, laneSweeps) reduction(max:slowest)
+    {
+        AlignedVector<double> bufA((size_t)n * L), bufB((size_t)n * L);
+        alignas(64) double diff[L];
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int p = 0; p < batch.numPacks(); p++) {
+            double* xOut = batch.packX(p);
+            double* cur = bufA.data();
+            double* next = bufB.data();
+            std::memcpy(cur, xOut, (size_t)n * L * sizeof(double));
+            int laneIters[L] = {};
+            bool retired[L];
+            int active = 0;
+            for (int l = 0; l < L; l++) {
+                retired[l] = p * L + l >= count;
+                active += !retired[l];
+            }
+
+            while (active > 0) {
+                sweep(batch.packA(p), batch.packB(p), cur, next, diff, n);
+                laneSweeps += L;
+                for (int l = 0; l < L; l++) {
+                    if (retired[l]) {
+                        continue;
+                    }
+                    laneIters[l]++;
+                    if (diff[l] < tolerance || laneIters[l] >= maxIterations) {
+                        for (int i = 0; i < n; i++) {
+                            xOut[i * L + l] = next[i * L + l];
+                        }
+                        iterations[p * L + l] = laneIters[l];
+                        systemSweeps += laneIters[l];
+                        slowest = std::max(slowest, laneIters[l]);
+                        retired[l] = true;
+                        active--;
+                    }
+                }
+                std::swap(cur, next);
+            }
+        }
+    }
+
+    BatchSolveStats stats;
+    stats.systemSweeps = systemSweeps;
+    stats.laneSweeps = laneSweeps;
+    stats.maxIterations = slowest;
+    return stats;
+}
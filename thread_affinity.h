@@ -0,0 +1,295 @@
+/*
+ * Thread Affinity and CPU Topology
+ * Socket/core/NUMA discovery and explicit pinning of OpenMP threads
+ *
+ * Pages of A are placed on the NUMA node of the thread that first writes
+ * them, so first-touch initialization only helps if the solver's threads run
+ * on the same CPUs as the initializing threads. pinThreads() binds OpenMP
+ * thread t of a team to one CPU:
+ *   compact: fill the physical cores of socket 0, then socket 1, ...
+ *            (SMT siblings after all cores of the socket)
+ *   scatter: round-robin over sockets, so every socket's memory
+ *            controllers are used from the first threads on
+ * The runtime keeps the same OS threads for later teams of the same size,
+ * so pinning once before a solve covers all of its parallel regions.
+ * Topology comes from /sys on Linux; elsewhere one socket is assumed and
+ * pinning is a no-op (use OMP_PROC_BIND / OMP_PLACES instead).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// Installed physical memory in bytes, or 0 if unknown
+inline size_t physicalMemoryBytes() {
+#if defined(__linux__)
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && pageSize > 0) {
+        return (size_t)pages * (size_t)pageSize;
+    }
+#endif
+    return 0;
+}
+
+enum class ThreadPlacement { None, Compact, Scatter };
+
+inline const char* placementName(ThreadPlacement p) {
+    switch (p) {
+    case ThreadPlacement::Compact: return "compact";
+    case ThreadPlacement::Scatter: return "scatter";
+    default: return "none";
+    }
+}
+
+inline bool parsePlacement(const char* name, ThreadPlacement& p) {
+    if (std::strcmp(name, "none") == 0) {
+        p = ThreadPlacement::None;
+    } else if (std::strcmp(name, "compact") == 0) {
+        p = ThreadPlacement::Compact;
+    } else if (std::strcmp(name, "scatter") == 0) {
+        p = ThreadPlacement::Scatter;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct CpuInfo {
+    int cpu;
+    int socket;
+    int core;
+    int node;    // NUMA node
+    int sibling; // SMT index within the core (0 = first hardware thread)
+};
+
+class CpuTopology {
+public:
+    // Read the topology of the CPUs this process may run on
+    static CpuTopology detect() {
+        CpuTopology topo;
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+            for (int c = 0; c < CPU_SETSIZE; c++) {
+                if (!CPU_ISSET(c, &allowed)) {
+                    continue;
+                }
+                std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/";
+                CpuInfo info{c, readInt(base + "physical_package_id", 0),
+                             readInt(base + "core_id", c), 0, 0};
+                topo.cpus_.push_back(info);
+            }
+        }
+
+        // NUMA node of each CPU from the node cpulists
+        for (int node = 0;; node++) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in) {
+                break;
+            }
+            std::string list;
+            std::getline(in, list);
+            for (int c : parseCpuList(list)) {
+                for (CpuInfo& info : topo.cpus_) {
+                    if (info.cpu == c) {
+                        info.node = node;
+                    }
+                }
+            }
+        }
+#endif
+        if (topo.cpus_.empty()) {
+            int count = std::max(1u, std::thread::hardware_concurrency());
+            for (int c = 0; c < count; c++) {
+                topo.cpus_.push_back({c, 0, c, 0, 0});
+            }
+        }
+
+        // Number the hardware threads of each core
+        for (size_t k = 0; k < topo.cpus_.size(); k++) {
+            for (size_t m = 0; m < k; m++) {
+                if (topo.cpus_[m].socket == topo.cpus_[k].socket &&
+                    topo.cpus_[m].core == topo.cpus_[k].core) {
+                    topo.cpus_[k].sibling++;
+                }
+            }
+        }
+        return topo;
+    }
+
+    const std::vector<CpuInfo>& cpus() const { return cpus_; }
+    int numCpus() const { return (int)cpus_.size(); }
+    int numSockets() const { return countDistinct(&CpuInfo::socket); }
+    int numNodes() const { return countDistinct(&CpuInfo::node); }
+
+    int numCores() const {
+        int cores = 0;
+        for (const CpuInfo& c : cpus_) {
+            cores += c.sibling == 0;
+        }
+        return cores;
+    }
+
+    // CPU for OpenMP thread 0, 1, 2, ... under the given placement
+    std::vector<CpuInfo> cpuOrder(ThreadPlacement placement) const {
+        std::vector<CpuInfo> compact = cpus_;
+        std::stable_sort(compact.begin(), compact.end(), [](const CpuInfo& a, const CpuInfo& b) {
+            if (a.socket != b.socket) return a.socket < b.socket;
+            if (a.sibling != b.sibling) return a.sibling < b.sibling;
+            return a.core < b.core;
+        });
+        if (placement != ThreadPlacement::Scatter) {
+            return compact;
+        }
+
+        // Deal the compact order of each socket out round-robin
+        std::vector<std::vector<CpuInfo>> perSocket;
+        for (const CpuInfo& c : compact) {
+            if (perSocket.empty() || perSocket.back().front().socket != c.socket) {
+                perSocket.emplace_back();
+            }
+            perSocket.back().push_back(c);
+        }
+        std::vector<CpuInfo> scatter;
+        for (size_t k = 0; scatter.size() < compact.size(); k++) {
+            for (const std::vector<CpuInfo>& s : perSocket) {
+                if (k < s.size()) {
+                    scatter.push_back(s[k]);
+                }
+            }
+        }
+        return scatter;
+    }
+
+    // Sockets used by the first numThreads CPUs of a placement
+    int socketsSpanned(ThreadPlacement placement, int numThreads) const {
+        std::vector<CpuInfo> order = cpuOrder(placement);
+        std::vector<int> seen;
+        for (int t = 0; t < numThreads; t++) {
+            int socket = order[t % order.size()].socket;
+            if (std::find(seen.begin(), seen.end(), socket) == seen.end()) {
+                seen.push_back(socket);
+            }
+        }
+        return (int)seen.size();
+    }
+
+    // Bind thread t of a numThreads team to cpuOrder(placement)[t];
+    // None restores the process's original CPU set. Returns false if
+    // pinning is unsupported.
+    bool pinThreads(int numThreads, ThreadPlacement placement) const {
+#if defined(__linux__)
+        std::vector<CpuInfo> order = cpuOrder(placement);
+        bool ok = true;
+        #pragma omp parallel num_threads(numThreads) reduction(&&:ok)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (placement == ThreadPlacement::None) {
+                for (const CpuInfo& c : cpus_) {
+                    CPU_SET(c.cpu, &set);
+                }
+            } else {
+                CPU_SET(order[omp_get_thread_num() % order.size()].cpu, &set);
+            }
+            ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+        }
+        return ok;
+#else
+        (void)numThreads;
+        return placement == ThreadPlacement::None;
+#endif
+    }
+
+    void print(std::ostream& os) const {
+        os << "CPU topology: " << numSockets() << " socket(s), " << numNodes()
+           << " NUMA node(s), " << numCores() << " core(s), " << numCpus()
+           << " hardware thread(s)" << std::endl;
+        for (int s = 0; s < numSockets(); s++) {
+            std::ostringstream list;
+            int count = 0;
+            for (const CpuInfo& c : cpuOrder(ThreadPlacement::Compact)) {
+                if (c.socket == socketId(s)) {
+                    list << (count++ ? "," : "") << c.cpu;
+                }
+            }
+            os << "  socket " << socketId(s) << ": cpus " << list.str() << std::endl;
+        }
+
+        const char* bind = "false";
+        switch (omp_get_proc_bind()) {
+        case omp_proc_bind_true: bind = "true"; break;
+        case omp_proc_bind_master: bind = "master"; break;
+        case omp_proc_bind_close: bind = "close"; break;
+        case omp_proc_bind_spread: bind = "spread"; break;
+        default: break;
+        }
+        os << "OpenMP binding: proc_bind=" << bind << ", places=" << omp_get_num_places()
+           << std::endl;
+    }
+
+private:
+    static int readInt(const std::string& path, int fallback) {
+        std::ifstream in(path);
+        int value;
+        return (in >> value) ? value : fallback;
+    }
+
+    // "0-3,8,10-11" -> {0,1,2,3,8,10,11}
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty()) {
+                continue;
+            }
+            size_t dash = range.find('-');
+            int lo = std::stoi(range.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+            for (int c = lo; c <= hi; c++) {
+                cpus.push_back(c);
+            }
+        }
+        return cpus;
+    }
+
+    int countDistinct(int CpuInfo::*field) const {
+        std::vector<int> seen;
+        for (const CpuInfo& c : cpus_) {
+            if (std::find(seen.begin(), seen.end(), c.*field) == seen.end()) {
+                seen.push_back(c.*field);
+            }
+        }
+        return (int)seen.size();
+    }
+
+    // Id of the s-th socket in ascending order
+    int socketId(int s) const {
+        std::vector<int> ids;
+        for (const CpuInfo& c : cpus_) {
+            if (std::find(ids.begin(), ids.end(), c.socket) == ids.end()) {
+                ids.push_back(c.socket);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids[s];
+    }
+
+    std::vector<CpuInfo> cpus_;
+};
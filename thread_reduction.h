@@ -0,0 +1,99 @@
+/*
+ * Thread Reductions
+ * Cache-line padded per-thread accumulators shared by the solvers
+ *
+ * Each thread owns one 64-byte slot, so partial results written from
+ * different threads never share a cache line. The reducer is meant to be
+ * allocated once per solve and reset between uses; threads keep their
+ * running value in a register and publish it once per parallel loop.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <omp.h>
+
+class ThreadReducer {
+public:
+    explicit ThreadReducer(int numThreads) : slots_(std::max(numThreads, 1)) {}
+
+    int size() const { return (int)slots_.size(); }
+
+    void reset(double identity = 0.0) {
+        for (Slot& s : slots_) {
+            s.value = identity;
+        }
+    }
+
+    // Slot of the calling thread (call inside a parallel region)
+    double& local() { return slots_[omp_get_thread_num()].value; }
+
+    void publishMax(double v) {
+        double& slot = local();
+        slot = std::max(slot, v);
+    }
+
+    void publishSum(double v) { local() += v; }
+
+    // Combine all slots (call outside the parallel loop, after its barrier)
+    double max() const {
+        double result = -std::numeric_limits<double>::infinity();
+        for (const Slot& s : slots_) {
+            result = std::max(result, s.value);
+        }
+        return result;
+    }
+
+    double sum() const {
+        double result = 0.0;
+        for (const Slot& s : slots_) {
+            result += s.value;
+        }
+        return result;
+    }
+
+private:
+    struct alignas(64) Slot {
+        double value = 0.0;
+    };
+
+    std::vector<Slot> slots_;
+};
+
+// Dot product a . b over n elements using the reducer's slots
+inline double parallelDot(const double* a, const double* b, int n, ThreadReducer& reducer) {
+    reducer.reset(0.0);
+    #pragma omp parallel num_threads(reducer.size())
+    {
+        double partial = 0.0;
+        #pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; i++) {
+            partial += a[i] * b[i];
+        }
+        reducer.publishSum(partial);
+    }
+    return reducer.sum();
+}
+
+// Euclidean norm ||a||_2
+inline double parallelNorm2(const double* a, int n, ThreadReducer& reducer) {
+    return std::sqrt(parallelDot(a, a, n, reducer));
+}
+
+// Max-norm of the difference ||a - b||_inf
+inline double parallelMaxDiff(const double* a, const double* b, int n, ThreadReducer& reducer) {
+    reducer.reset(0.0);
+    #pragma omp parallel num_threads(reducer.size())
+    {
+        double partial = 0.0;
+        #pragma omp for schedule(static) nowait
+        for (int i = 0; i < n; i++) {
+            partial = std::max(partial, std::fabs(a[i] - b[i]));
+        }
+        reducer.publishMax(partial);
+    }
+    return reducer.max();
+}
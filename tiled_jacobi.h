@@ -0,0 +1,259 @@
+/*
+ * Cache-Blocked Dense Jacobi Sweep
+ * Row- and column-tiled mat-vec with register blocking and startup tuning
+ *
+ * The plain sweep streams x once per row, so once x outgrows the cache
+ * closest to the core every row re-fetches it from further out. The tiled
+ * sweep splits each thread's rows into column tiles of colBlock entries:
+ * all of the thread's rows consume one x tile before the next is touched,
+ * so the tile stays in L1/L2 and row sums are accumulated per tile.
+ * Inside a tile, rowBlock rows are processed together (rowsDot<R>): every
+ * x vector loaded into a register is reused for R rows, cutting x loads
+ * by a factor of R. colBlock = 0 means one tile spanning the whole row.
+ *
+ * tuneTiles() times a few sweeps of each candidate configuration on the
+ * actual system and returns the fastest, so tile sizes follow the cache
+ * sizes of the machine the solver runs on.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <omp.h>
+
+#include "dense_matrix.h"
+#include "jacobi_kernels.h"
+#include "thread_reduction.h"
+
+struct TileConfig {
+    int rowBlock = 1; // rows sharing each loaded x vector (1, 2, 4 or 8)
+    int colBlock = 0; // x tile length in doubles; 0 = whole row
+};
+
+// out[r] += dot(a[r], x) for R rows over len entries
+typedef void (*RowsDotFn)(const double* const* a, const double* x, int len, double* out);
+
+template <int R>
+inline void rowsDotScalar(const double* const* a, const double* x, int len, double* out) {
+    double acc[R] = {};
+    for (int j = 0; j < len; j++) {
+        double xj = x[j];
+#pragma GCC unroll 8
+        for (int r = 0; r < R; r++) {
+            acc[r] += a[r][j] * xj;
+        }
+    }
+    for (int r = 0; r < R; r++) {
+        out[r] += acc[r];
+    }
+}
+
+#ifdef JACOBI_HAVE_X86_DISPATCH
+template <int R>
+__attribute__((target("avx2,fma")))
+inline void rowsDotAvx2(const double* const* a, const double* x, int len, double* out) {
+    __m256d acc[R];
+#pragma GCC unroll 8
+    for (int r = 0; r < R; r++) {
+        acc[r] = _mm256_setzero_pd();
+    }
+    int j = 0;
+    for (; j + 4 <= len; j += 4) {
+        __m256d xv = _mm256_loadu_pd(x + j);
+#pragma GCC unroll 8
+        for (int r = 0; r < R; r++) {
+            acc[r] = _mm256_fmadd_pd(_mm256_loadu_pd(a[r] + j), xv, acc[r]);
+        }
+    }
+    for (int r = 0; r < R; r++) {
+        __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(acc[r]), _mm256_extractf128_pd(acc[r], 1));
+        double sum = _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+        for (int k = j; k < len; k++) {
+            sum += a[r][k] * x[k];
+        }
+        out[r] += sum;
+    }
+}
+
+template <int R>
+__attribute__((target("avx512f")))
+inline void rowsDotAvx512(const double* const* a, const double* x, int len, double* out) {
+    __m512d acc[R];
+#pragma GCC unroll 8
+    for (int r = 0; r < R; r++) {
+        acc[r] = _mm512_setzero_pd();
+    }
+    int j = 0;
+    for (; j + 8 <= len; j += 8) {
+        __m512d xv = _mm512_loadu_pd(x + j);
+#pragma GCC unroll 8
+        for (int r = 0; r < R; r++) {
+            acc[r] = _mm512_fmadd_pd(_mm512_loadu_pd(a[r] + j), xv, acc[r]);
+        }
+    }
+    if (j < len) {
+        __mmask8 mask = (__mmask8)((1u << (len - j)) - 1u);
+        __m512d xv = _mm512_maskz_loadu_pd(mask, x + j);
+#pragma GCC unroll 8
+        for (int r = 0; r < R; r++) {
+            acc[r] = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a[r] + j), xv, acc[r]);
+        }
+    }
+    alignas(64) double lanes[8];
+    for (int r = 0; r < R; r++) {
+        _mm512_store_pd(lanes, acc[r]);
+        out[r] += ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+                  ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+}
+#endif
+
+// Best rowsDot<R> for the running CPU; R must be 1, 2, 4 or 8
+template <int R>
+inline RowsDotFn selectRowsDot() {
+#ifdef JACOBI_HAVE_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return rowsDotAvx512<R>;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return rowsDotAvx2<R>;
+    }
+#endif
+    return rowsDotScalar<R>;
+}
+
+// Row block the sweep actually uses for a requested one: the largest of
+// 8, 4, 2, 1 not above it, so the kernel and the loop step always agree
+inline int supportedRowBlock(int rowBlock) {
+    return rowBlock >= 8 ? 8 : rowBlock >= 4 ? 4 : rowBlock >= 2 ? 2 : 1;
+}
+
+// Kernel for supportedRowBlock(rowBlock) rows
+inline RowsDotFn activeRowsDot(int rowBlock) {
+    switch (supportedRowBlock(rowBlock)) {
+    case 8: return selectRowsDot<8>();
+    case 4: return selectRowsDot<4>();
+    case 2: return selectRowsDot<2>();
+    default: return selectRowsDot<1>();
+    }
+}
+
+// Tiled parallel Jacobi; same interface and stopping rule as jacobiParallel.
+// Each thread owns a contiguous range of whole row blocks (the static row
+// partition), accumulates its row sums over the column tiles, then updates.
+inline int jacobiParallelTiled(const DenseMatrix& A, const std::vector<double>& b,
+                               std::vector<double>& x, int n, double tolerance,
+                               int maxIterations, int numThreads, const TileConfig& tiles) {
+    std::vector<double> x_new(n, 0.0);
+    std::vector<double> sums(n, 0.0);
+    const int rb = supportedRowBlock(tiles.rowBlock);
+    const int cb = tiles.colBlock > 0 ? std::min(tiles.colBlock, n) : n;
+    RowsDotFn blockDot = activeRowsDot(rb);
+    RowsDotFn singleDot = activeRowsDot(1);
+    ThreadReducer maxDiffReducer(numThreads);
+    int iterations = 0;
+    bool converged = false;
+    const double* finalX = x.data();
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        const int t = omp_get_thread_num();
+        const int T = omp_get_num_threads();
+        const int blocks = (n + rb - 1) / rb;
+        const int lo = std::min(n, (int)((long long)blocks * t / T) * rb);
+        const int hi = std::min(n, (int)((long long)blocks * (t + 1) / T) * rb);
+        double* cur = x.data();
+        double* next = x_new.data();
+        double* rowSum = sums.data();
+        int iter = 0;
+
+        while (iter < maxIterations) {
+            std::fill(rowSum + lo, rowSum + hi, 0.0);
+            for (int j0 = 0; j0 < n; j0 += cb) {
+                const int len = std::min(cb, n - j0);
+                const double* xTile = cur + j0;
+                int i = lo;
+                for (; i + rb <= hi; i += rb) {
+                    const double* rows[8];
+                    for (int r = 0; r < rb; r++) {
+                        rows[r] = A.rowPtr(i + r) + j0;
+                    }
+                    blockDot(rows, xTile, len, rowSum + i);
+                }
+                for (; i < hi; i++) {
+                    const double* row = A.rowPtr(i) + j0;
+                    singleDot(&row, xTile, len, rowSum + i);
+                }
+            }
+
+            double localMax = 0.0;
+            for (int i = lo; i < hi; i++) {
+                const double* Ai = A.rowPtr(i);
+                next[i] = (b[i] - (rowSum[i] - Ai[i] * cur[i])) / Ai[i];
+                localMax = std::max(localMax, std::fabs(next[i] - cur[i]));
+            }
+            maxDiffReducer.publishMax(localMax);
+            #pragma omp barrier
+
+            #pragma omp single
+            {
+                converged = maxDiffReducer.max() < tolerance;
+                maxDiffReducer.reset(0.0);
+            }
+
+            std::swap(cur, next);
+            iter++;
+            if (converged) {
+                break;
+            }
+        }
+
+        #pragma omp master
+        {
+            iterations = iter;
+            finalX = cur;
+        }
+    }
+
+    if (finalX != x.data()) {
+        x.swap(x_new);
+    }
+    return iterations;
+}
+
+// Candidate tiles: register blocks of 1-8 rows, x tiles of 16 KB (a third
+// of a typical L1d) and 64 KB (L2-resident), or the whole row
+inline std::vector<TileConfig> tileCandidates(int n) {
+    std::vector<TileConfig> candidates;
+    for (int rowBlock : {1, 2, 4, 8}) {
+        candidates.push_back({rowBlock, 0});
+        for (int colBlock : {2048, 8192}) {
+            if (colBlock < n) {
+                candidates.push_back({rowBlock, colBlock});
+            }
+        }
+    }
+    return candidates;
+}
+
+// Time `trialSweeps` sweeps of every candidate on A and return the fastest
+inline TileConfig tuneTiles(const DenseMatrix& A, const std::vector<double>& b, int n,
+                            int numThreads, int trialSweeps = 2) {
+    TileConfig best;
+    double bestTime = 0.0;
+    std::vector<double> x(n);
+    for (const TileConfig& tiles : tileCandidates(n)) {
+        std::fill(x.begin(), x.end(), 0.0);
+        double start = omp_get_wtime();
+        jacobiParallelTiled(A, b, x, n, 0.0, trialSweeps, numThreads, tiles);
+        double elapsed = omp_get_wtime() - start;
+        if (bestTime == 0.0 || elapsed < bestTime) {
+            best = tiles;
+            bestTime = elapsed;
+        }
+    }
+    return best;
+}
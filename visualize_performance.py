@@ -4,14 +4,19 @@ Jacobi Method Performance Visualization
 Parses output from jacobi_parallel and creates performance charts
 """
 
+import argparse
+import csv
+import json
 import subprocess
 import re
 import matplotlib.pyplot as plt
 import numpy as np
 import os
 
-def compile_and_run_parallel():
-    """Compile and run the parallel Jacobi program"""
+RESULTS_FILE = 'jacobi_results.json'
+
+def compile_and_run_parallel(backend='all', extra_args=()):
+    """Compile and run the parallel Jacobi program; returns the results file"""
     # Compile
     compile_cmd = [
         "clang++", "-Xpreprocessor", "-fopenmp",
@@ -25,15 +30,61 @@ def compile_and_run_parallel():
     subprocess.run(compile_cmd, check=True)
     
     print("Running jacobi_parallel...")
-    result = subprocess.run(["./jacobi_parallel"], capture_output=True, text=True)
-    return result.stdout
+    subprocess.run(["./jacobi_parallel", f"--backend={backend}",
+                    f"--output={RESULTS_FILE}", *extra_args], check=True)
+    return RESULTS_FILE
+
+def load_results(path):
+    """Read the JSON or CSV written by jacobi_parallel --output (median times)"""
+    scaling, roofline = [], None
+    if path.endswith('.csv'):
+        with open(path, newline='') as f:
+            records = [{'n': int(r['n']), 'threads': int(r['threads']),
+                        'variant': r['variant'], 'median': float(r['median_ms']),
+                        'p95': float(r['p95_ms']), 'gflops': float(r['gflops'])}
+                       for r in csv.DictReader(f)]
+    else:
+        with open(path) as f:
+            report = json.load(f)
+        records = [{'n': r['n'], 'threads': r['threads'], 'variant': r['variant'],
+                    'median': r['time_ms']['median'], 'p95': r['time_ms']['p95'],
+                    'gflops': r['gflops']}
+                   for r in report['results']]
+        # Model fits and machine peaks (JSON only)
+        scaling = [m for m in report.get('scaling', []) if m['valid']]
+        roofline = report.get('roofline')
+    
+    data = {
+        'sizes': [],
+        'sequential_times': [],
+        'parallel_results': {},  # {threads: {size: time}}
+        'device_times': {},      # {size: time}
+        'records': records,
+        'scaling': scaling,      # fitted model per size
+        'roofline': roofline     # peak GFLOP/s, STREAM GB/s, sweep intensity
+    }
+    for r in records:
+        size = r['n']
+        if size not in data['sizes']:
+            data['sizes'].append(size)
+        if r['variant'] == 'sequential':
+            data['sequential_times'].append(r['median'])
+        elif r['variant'] == 'parallel':
+            data['parallel_results'].setdefault(r['threads'], {})[size] = r['median']
+        elif r['variant'] == 'device':
+            data['device_times'][size] = r['median']
+    return data
 
 def parse_output(output):
     """Parse the program output to extract performance data"""
     data = {
         'sizes': [],
         'sequential_times': [],
-        'parallel_results': {}  # {threads: {size: time}}
+        'parallel_results': {},  # {threads: {size: time}}
+        'device_times': {},      # {size: time}
+        'records': [],
+        'scaling': [],           # model fits come with --results files only
+        'roofline': None
     }
     
     current_size = None
@@ -44,6 +95,10 @@ def parse_output(output):
     while i < len(lines):
         line = lines[i]
         
+        # Weak-scaling tables (jacobi_mpi) do not belong to a single size
+        if 'Weak scaling' in line:
+            current_size = None
+        
         # Match matrix size
         size_match = re.search(r'Matrix size:\s*(\d+)\s*x\s*\d+', line)
         if size_match:
@@ -61,6 +116,14 @@ def parse_output(output):
                     data['sequential_times'].append(seq_time)
                     break
         
+        # Match device backend time
+        if 'Device (OpenMP target):' in line and current_size is not None:
+            for j in range(i, min(i+5, len(lines))):
+                time_match = re.search(r'Time:\s*([\d.]+)\s*ms', lines[j])
+                if time_match:
+                    data['device_times'][current_size] = float(time_match.group(1))
+                    break
+        
         # Match parallel results table
         thread_match = re.match(r'\s*(\d+)\s+([\d.]+)\s+([\d.]+)\s+([\d.]+)%', line)
         if thread_match and current_size is not None:
@@ -203,6 +266,146 @@ def create_visualizations(data):
     
     plt.show()
 
+def create_device_comparison(data):
+    """Compare the device backend against sequential and the best CPU run"""
+    device_times = data['device_times']
+    sizes = [s for s in data['sizes'] if s in device_times]
+    if not sizes:
+        return
+    parallel_results = data['parallel_results']
+    
+    seq = [data['sequential_times'][data['sizes'].index(s)] for s in sizes]
+    best_cpu = []
+    for size in sizes:
+        times = [r[size] for r in parallel_results.values() if size in r]
+        best_cpu.append(min(times) if times else 0)
+    device = [device_times[s] for s in sizes]
+    
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 5))
+    fig.suptitle('Jacobi Iterative Method - Device Offload vs OpenMP CPU',
+                 fontsize=14, fontweight='bold')
+    
+    # 1. Time to solution per backend
+    x = np.arange(len(sizes))
+    width = 0.25
+    ax1.bar(x - width, seq, width, label='Sequential', color='gray', edgecolor='black')
+    if any(best_cpu):
+        ax1.bar(x, best_cpu, width, label='Best OpenMP CPU', color='tab:blue', edgecolor='black')
+    ax1.bar(x + width, device, width, label='Device (OpenMP target)',
+            color='tab:green', edgecolor='black')
+    ax1.set_xlabel('Matrix Size')
+    ax1.set_ylabel('Execution Time (ms)')
+    ax1.set_title('Time to Solution')
+    ax1.set_xticks(x)
+    ax1.set_xticklabels([f'{s}x{s}' for s in sizes])
+    ax1.set_yscale('log')
+    ax1.legend(loc='upper left', fontsize=8)
+    ax1.grid(True, alpha=0.3)
+    
+    # 2. Device speedup over sequential and over the best CPU run
+    ax2.plot(sizes, [t / d for t, d in zip(seq, device)], 'o-',
+             label='vs Sequential', linewidth=2, markersize=8)
+    if any(best_cpu):
+        ax2.plot(sizes, [c / d if c > 0 else 0 for c, d in zip(best_cpu, device)], 's-',
+                 label='vs Best OpenMP CPU', linewidth=2, markersize=8)
+    ax2.axhline(y=1, color='k', linestyle='--', linewidth=1.5, alpha=0.7)
+    ax2.set_xlabel('Matrix Size (n)')
+    ax2.set_ylabel('Speedup')
+    ax2.set_title('Device Speedup')
+    ax2.legend(loc='upper left', fontsize=8)
+    ax2.grid(True, alpha=0.3)
+    
+    plt.tight_layout()
+    
+    output_file = 'jacobi_device_comparison.png'
+    plt.savefig(output_file, dpi=150, bbox_inches='tight')
+    print(f"Device comparison saved to: {output_file}")
+
+def predict_time(model, threads):
+    """Scaling model of jacobi_parallel (scaling_model.h) at P threads"""
+    t1, s = model['t1_ms'], model['serial_fraction']
+    floor = t1 / model['max_speedup'] if model['max_speedup'] else 0.0
+    return max(t1 * (s + (1 - s) / threads), floor) + model['overhead_ms'] * (threads - 1)
+
+def create_model_plots(data):
+    """Measured vs predicted speedup, and each kernel variant on the roofline"""
+    models = data['scaling']
+    roofline = data['roofline']
+    if not models and not roofline:
+        return
+    
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 5))
+    fig.suptitle('Jacobi Iterative Method - Scaling Model and Roofline',
+                 fontsize=14, fontweight='bold')
+    
+    # 1. Measured speedup (markers) and the fitted model (lines)
+    colors = plt.cm.viridis(np.linspace(0.2, 0.8, max(1, len(models))))
+    for idx, model in enumerate(models):
+        size = model['n']
+        measured = sorted((t, r[size]) for t, r in data['parallel_results'].items()
+                          if size in r)
+        p_max = max([model['max_threads']] + [t for t, _ in measured])
+        threads = np.arange(1, p_max + 1)
+        ax1.plot(threads, [model['t1_ms'] / predict_time(model, p) for p in threads], '-',
+                 color=colors[idx], linewidth=2,
+                 label=f"{size}x{size} model (best {model['best_threads']})")
+        ax1.plot([t for t, _ in measured], [model['t1_ms'] / ms for _, ms in measured], 'o',
+                 color=colors[idx], markersize=8)
+    if models:
+        p_max = max(m['max_threads'] for m in models)
+        ax1.plot([1, p_max], [1, p_max], 'k--', label='Ideal', linewidth=1.5, alpha=0.7)
+    ax1.set_xlabel('Number of Threads')
+    ax1.set_ylabel('Speedup over 1 thread')
+    ax1.set_title('Measured (markers) vs Predicted (lines)')
+    ax1.legend(loc='upper left', fontsize=8)
+    ax1.grid(True, alpha=0.3)
+    
+    # 2. Roofline with the best GFLOP/s of every variant per size
+    if roofline:
+        peak, bw = roofline['peak_gflops'], roofline['stream_gbs']
+        intensity = roofline['dense_sweep_intensity']
+        ridge = peak / bw
+        xs = np.logspace(np.log10(min(intensity, ridge) / 4),
+                         np.log10(max(intensity, ridge) * 4), 100)
+        ax2.plot(xs, np.minimum(peak, xs * bw), 'k-', linewidth=2,
+                 label=f'Roofline ({peak:.0f} GFLOP/s, {bw:.1f} GB/s)')
+        variants = sorted({r['variant'] for r in data['records']})
+        markers = ['o', 's', '^', 'D', 'v']
+        for idx, variant in enumerate(variants):
+            best = {}
+            for r in data['records']:
+                if r['variant'] == variant:
+                    best[r['n']] = max(best.get(r['n'], 0), r['gflops'])
+            # Same intensity for every dense variant: spread the sizes slightly
+            offsets = np.linspace(0.9, 1.1, max(1, len(best)))
+            ax2.scatter([intensity * o for o in offsets], list(best.values()),
+                        marker=markers[idx % len(markers)], s=60, label=variant)
+        ax2.set_xscale('log')
+        ax2.set_yscale('log')
+        ax2.set_xlabel('Operational Intensity (flop/byte)')
+        ax2.set_ylabel('GFLOP/s')
+        ax2.set_title('Roofline Position of Each Variant')
+        ax2.legend(loc='upper left', fontsize=8)
+        ax2.grid(True, alpha=0.3, which='both')
+    
+    plt.tight_layout()
+    
+    output_file = 'jacobi_scaling_model.png'
+    plt.savefig(output_file, dpi=150, bbox_inches='tight')
+    print(f"Scaling model saved to: {output_file}")
+
+def print_model_table(data):
+    """Print the fitted scaling model of every size"""
+    if not data['scaling']:
+        return
+    print("\nSCALING MODEL: T(P) = max(T1 (s + (1-s)/P), T1/Smax) + c (P-1)")
+    print(f"{'Size':<12}{'s':<10}{'Smax':<10}{'c (ms)':<12}{'Fit err':<10}{'Best threads':<12}")
+    for m in data['scaling']:
+        smax = f"{m['max_speedup']:.2f}" if m['max_speedup'] else '-'
+        error = f"{m['rms_error'] * 100:.1f}%"
+        print(f"{m['n']}x{m['n']:<6}{m['serial_fraction']:<10.3f}{smax:<10}"
+              f"{m['overhead_ms']:<12.3f}{error:<10}{m['best_threads']:<12}")
+
 def print_summary_table(data):
     """Print a summary table of results"""
     sizes = data['sizes']
@@ -218,6 +421,8 @@ def print_summary_table(data):
     header = f"{'Size':<12}{'Sequential':<15}"
     for t in thread_counts:
         header += f"{t} Thread(s)".center(15)
+    if data['device_times']:
+        header += "Device".center(15)
     print(header)
     print("-"*80)
     
@@ -227,13 +432,36 @@ def print_summary_table(data):
             par_time = parallel_results[threads].get(size, 0)
             speedup = seq_times[idx] / par_time if par_time > 0 else 0
             row += f"{par_time:.2f} ({speedup:.2f}x)".center(15)
+        if data['device_times']:
+            dev_time = data['device_times'].get(size, 0)
+            speedup = seq_times[idx] / dev_time if dev_time > 0 else 0
+            row += f"{dev_time:.2f} ({speedup:.2f}x)".center(15)
         print(row)
     
     print("="*80)
 
 def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--input', metavar='FILE',
+                        help='parse saved program output (e.g. from mpirun ./jacobi_mpi) '
+                             'instead of compiling and running jacobi_parallel')
+    parser.add_argument('--results', metavar='FILE',
+                        help='read a JSON/CSV results file written by '
+                             'jacobi_parallel --output=FILE')
+    parser.add_argument('--sizes', metavar='N,N,...',
+                        help='matrix sizes for jacobi_parallel (default: its own list)')
+    parser.add_argument('--threads', metavar='T,T,...',
+                        help='thread counts for jacobi_parallel')
+    parser.add_argument('--trials', type=int, default=5,
+                        help='timed trials per configuration (default: 5)')
+    parser.add_argument('--backend', choices=['cpu', 'device', 'all'], default='all',
+                        help='backends jacobi_parallel runs (default: all)')
+    args = parser.parse_args()
+    
     # Change to script directory
     script_dir = os.path.dirname(os.path.abspath(__file__))
+    input_path = os.path.abspath(args.input) if args.input else None
+    results_path = os.path.abspath(args.results) if args.results else None
     os.chdir(script_dir)
     
     print("="*60)
@@ -241,24 +469,42 @@ def main():
     print("="*60)
     
     try:
-        # Compile and run the parallel program
-        output = compile_and_run_parallel()
-        
-        # Parse the output
-        data = parse_output(output)
-        
-        if not data['sizes']:
-            print("Error: Could not parse program output")
-            print("Raw output:")
-            print(output)
-            return
+        if input_path:
+            # Saved text output (e.g. jacobi_mpi): scrape the tables
+            with open(input_path) as f:
+                output = f.read()
+            data = parse_output(output)
+            if not data['sizes']:
+                print("Error: Could not parse program output")
+                print("Raw output:")
+                print(output)
+                return
+        else:
+            if not results_path:
+                # Compile and run the parallel program in harness mode
+                extra_args = [f"--trials={args.trials}"]
+                if args.sizes:
+                    extra_args.append(f"--sizes={args.sizes}")
+                if args.threads:
+                    extra_args.append(f"--threads={args.threads}")
+                results_path = compile_and_run_parallel(args.backend, extra_args)
+            data = load_results(results_path)
+            if not data['sizes']:
+                print(f"Error: no results in {results_path}")
+                return
         
         # Print summary table
         print_summary_table(data)
+        print_model_table(data)
         
         # Create visualizations
         print("\nGenerating visualizations...")
-        create_visualizations(data)
+        create_device_comparison(data)
+        create_model_plots(data)
+        if data['parallel_results']:
+            create_visualizations(data)
+        else:
+            plt.show()
         
     except subprocess.CalledProcessError as e:
         print(f"Error compiling/running program: {e}")